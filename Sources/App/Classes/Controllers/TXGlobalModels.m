@@ -212,6 +212,167 @@ NSDateFormatter *TXSharedISOStandardDateFormatter(void)
 	return _isoStandardDateFormatter;
 }
 
+#if defined(DEBUG)
+static void TXVerifyISOStandardDateStringParser(void);
+#endif
+
+static BOOL _TXParseISOStandardDateString(NSString *dateString, NSTimeInterval *timeInterval);
+
+/* Parses the fixed layout produced by TXSharedISOStandardDateFormatter()
+ without involving NSDateFormatter or allocating any objects.
+ Returns NO for anything that does not match the layout exactly
+ so that the caller can fall back to the formatter. */
+BOOL TXParseISOStandardDateString(NSString *dateString, NSTimeInterval *timeInterval)
+{
+	NSCParameterAssert(dateString != nil);
+	NSCParameterAssert(timeInterval != NULL);
+
+#if defined(DEBUG)
+	static dispatch_once_t onceToken;
+
+	dispatch_once(&onceToken, ^{
+		TXVerifyISOStandardDateStringParser();
+	});
+#endif
+
+	return _TXParseISOStandardDateString(dateString, timeInterval);
+}
+
+static BOOL _TXParseISOStandardDateString(NSString *dateString, NSTimeInterval *timeInterval)
+{
+	/* 2011-10-19T16:40:51.620Z */
+	static NSUInteger const layoutLength = 24;
+
+	if (dateString.length != layoutLength) {
+		return NO;
+	}
+
+	unichar c[layoutLength];
+
+	[dateString getCharacters:c range:NSMakeRange(0, layoutLength)];
+
+	if (c[4] != '-' || c[7] != '-' || c[10] != 'T' ||
+		c[13] != ':' || c[16] != ':' || c[19] != '.' || c[23] != 'Z')
+	{
+		return NO;
+	}
+
+#define _digitAt(index)		(c[(index)] - '0')
+
+	static NSUInteger const digitIndexes[] = {0, 1, 2, 3, 5, 6, 8, 9, 11, 12, 14, 15, 17, 18, 20, 21, 22};
+
+	for (NSUInteger i = 0; i < (sizeof(digitIndexes) / sizeof(digitIndexes[0])); i++) {
+		unichar character = c[digitIndexes[i]];
+
+		if (character < '0' || character > '9') {
+			return NO;
+		}
+	}
+
+	NSInteger year = ((_digitAt(0) * 1000) + (_digitAt(1) * 100) + (_digitAt(2) * 10) + _digitAt(3));
+	NSInteger month = ((_digitAt(5) * 10) + _digitAt(6));
+	NSInteger day = ((_digitAt(8) * 10) + _digitAt(9));
+	NSInteger hour = ((_digitAt(11) * 10) + _digitAt(12));
+	NSInteger minute = ((_digitAt(14) * 10) + _digitAt(15));
+	NSInteger second = ((_digitAt(17) * 10) + _digitAt(18));
+	NSInteger millisecond = ((_digitAt(20) * 100) + (_digitAt(21) * 10) + _digitAt(22));
+
+#undef _digitAt
+
+	if (month < 1 || month > 12 || hour > 23 || minute > 59 || second > 59) {
+		return NO;
+	}
+
+	BOOL isLeapYear = (((year % 4) == 0 && (year % 100) != 0) || (year % 400) == 0);
+
+	static NSInteger const daysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+	NSInteger monthLength = daysInMonth[(month - 1)];
+
+	if (month == 2 && isLeapYear) {
+		monthLength += 1;
+	}
+
+	if (day < 1 || day > monthLength) {
+		return NO;
+	}
+
+	/* Days since the epoch for a proleptic Gregorian date.
+	 Source: <http://howardhinnant.github.io/date_algorithms.html> */
+	NSInteger y = ((month <= 2) ? (year - 1) : year);
+	NSInteger era = (((y >= 0) ? y : (y - 399)) / 400);
+	NSInteger yearOfEra = (y - (era * 400));
+	NSInteger dayOfYear = ((((153 * ((month > 2) ? (month - 3) : (month + 9))) + 2) / 5) + (day - 1));
+	NSInteger dayOfEra = ((yearOfEra * 365) + (yearOfEra / 4) - (yearOfEra / 100) + dayOfYear);
+	NSInteger daysSinceEpoch = ((era * 146097) + dayOfEra - 719468);
+
+	*timeInterval = ((daysSinceEpoch * 86400) + (hour * 3600) + (minute * 60) + second + (millisecond / 1000.0));
+
+	return YES;
+}
+
+#if defined(DEBUG)
+/* Verify the parser against the formatter it stands in for using a
+ corpus of edge cases and of dates spread across a few centuries. */
+static void TXVerifyISOStandardDateStringParser(void)
+{
+	NSDateFormatter *dateFormatter = TXSharedISOStandardDateFormatter();
+
+	NSMutableArray<NSString *> *dateStrings = [NSMutableArray arrayWithArray:@[
+		@"1970-01-01T00:00:00.000Z",
+		@"1969-12-31T23:59:59.999Z",
+		@"1900-02-28T12:00:00.500Z",
+		@"2000-02-29T23:59:59.999Z",
+		@"2011-10-19T16:40:51.620Z",
+		@"2016-12-31T23:59:59.001Z",
+		@"2038-01-19T03:14:08.000Z",
+		@"2100-03-01T00:00:00.000Z"
+	]];
+
+	for (NSUInteger i = 0; i < 5000; i++) {
+		/* Between 1900 and 2200 with millisecond precision */
+		NSTimeInterval timeInterval = (-2208988800.0 + (arc4random_uniform(UINT32_MAX) * 2.2) + (arc4random_uniform(1000) / 1000.0));
+
+		[dateStrings addObject:[dateFormatter stringFromDate:[NSDate dateWithTimeIntervalSince1970:timeInterval]]];
+	}
+
+	for (NSString *dateString in dateStrings) {
+		NSTimeInterval timeInterval = 0;
+
+		BOOL parseResult = _TXParseISOStandardDateString(dateString, &timeInterval);
+
+		NSDate *dateObject = [dateFormatter dateFromString:dateString];
+
+		NSCAssert(parseResult, @"Date string was not parsed: '%@'", dateString);
+
+		NSCAssert((fabs(timeInterval - dateObject.timeIntervalSince1970) < 0.0005),
+			@"Date string parsed as %f instead of %f: '%@'", timeInterval, dateObject.timeIntervalSince1970, dateString);
+	}
+
+	/* Strings that do not match the layout are left to the formatter */
+	NSArray<NSString *> *dateStringsNotParsed = @[
+		@"2011-10-19T16:40:51Z",
+		@"2011-10-19 16:40:51.620Z",
+		@"2011-10-19T16:40:51.620+00:00",
+		@"2011-13-19T16:40:51.620Z",
+		@"2011-10-32T16:40:51.620Z",
+		@"2019-02-29T16:40:51.620Z",
+		@"1900-02-29T16:40:51.620Z",
+		@"2011-10-19T24:40:51.620Z",
+		@"2011-10-19T16:60:51.620Z",
+		@"2011-10-19T16:40:60.620Z",
+		@"2011-1O-19T16:40:51.620Z"
+	];
+
+	for (NSString *dateString in dateStringsNotParsed) {
+		NSTimeInterval timeInterval = 0;
+
+		NSCAssert((_TXParseISOStandardDateString(dateString, &timeInterval) == NO),
+			@"Date string should not have been parsed: '%@'", dateString);
+	}
+}
+#endif
+
 #pragma mark -
 #pragma mark Misc
 
@@ -188,6 +188,11 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	NSTableCellView *result = [tableView makeViewWithIdentifier:tableColumn.identifier owner:self];
 
+	/* Lines are fetched from the historic log once their row is shown */
+	IRCHighlightLogEntry *entryItem = self.highlightListController.arrangedObjects[row];
+
+	[entryItem fetchLineLoggedIfNeeded];
+
 	return result;
 }
 
@@ -114,6 +114,7 @@ typedef NS_ENUM(NSUInteger, IRCLocalCommand) {
 	IRCLocalCommandRecv = 5087,
 	IRCLocalCommandRejoin = 5060,
 	IRCLocalCommandRemove = 5061,
+	IRCLocalCommandReplay = 5119,
 	IRCLocalCommandServer = 5062,
 	IRCLocalCommandSetcolor = 5103,
 	IRCLocalCommandSetqueryname = 5117,
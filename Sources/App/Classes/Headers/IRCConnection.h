@@ -77,6 +77,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)ircConnectionDidCloseReadStream:(IRCConnection *)sender;
 - (void)ircConnection:(IRCConnection *)sender didDisconnectWithError:(nullable NSError *)disconnectError;
 - (void)ircConnection:(IRCConnection *)sender didReceiveData:(NSString *)data;
+- (void)ircConnection:(IRCConnection *)sender didReceiveLines:(NSArray<NSString *> *)lines;
 - (void)ircConnection:(IRCConnection *)sender willSendData:(NSString *)data;
 @end
 
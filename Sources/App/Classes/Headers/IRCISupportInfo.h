@@ -48,6 +48,16 @@ typedef NS_ENUM(NSUInteger, IRCISupportInfoListType)
 	IRCISupportInfoListTypeQuiet
 };
 
+/* CASEMAPPING defines which characters are considered the same,
+ ignoring case, when comparing nicknames and channel names. */
+typedef NS_ENUM(NSUInteger, IRCISupportInfoCaseMapping)
+{
+	IRCISupportInfoCaseMappingRFC1459 = 0, // A-Z[\]^ = a-z{|}~ (default)
+	IRCISupportInfoCaseMappingStrictRFC1459, // A-Z[\] = a-z{|}
+	IRCISupportInfoCaseMappingASCII, // A-Z = a-z
+	IRCISupportInfoCaseMappingUnicode // Any other value
+};
+
 #define IRCISupportInfoHighestUserPrefixRank			100
 
 #define IRCISupportUserModeSymbolsSymbolsKey			@"modeSymbols"
@@ -62,6 +72,8 @@ typedef NS_ENUM(NSUInteger, IRCISupportInfoListType)
 @property (readonly) NSUInteger maximumNicknameLength;
 @property (readonly) NSUInteger maximumTopicLength; // 0 = no limit
 @property (readonly) NSUInteger maximumModeCount;
+@property (readonly) IRCISupportInfoCaseMapping caseMapping;
+@property (readonly) BOOL supportsWHOX;
 @property (readonly, copy) NSArray<NSString *> *channelNamePrefixes;
 @property (readonly, copy) NSArray<NSString *> *statusMessageModeSymbols;
 @property (readonly, copy) NSDictionary<NSString *, NSNumber *> *channelModes;
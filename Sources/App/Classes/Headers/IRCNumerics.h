@@ -86,6 +86,7 @@ enum {
 	RPL_ENDOFEXCEPTLIST = 349,
 	RPL_WHOREPLY = 352,
 	RPL_NAMEREPLY = 353,
+	RPL_WHOSPCRPL = 354,
 	RPL_ENDOFNAMES = 366,
 	RPL_BANLIST = 367,
 	RPL_ENDOFBANLIST = 368,
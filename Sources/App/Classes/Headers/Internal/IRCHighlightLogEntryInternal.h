@@ -43,8 +43,11 @@ NS_ASSUME_NONNULL_BEGIN
 {
 @protected
 	TVCLogLine *_lineLogged;
+	NSDate *_timeLogged;
+	NSString *_lineNumber;
 	NSString *_clientId;
 	NSString *_channelId;
+	BOOL _lineLoggedFetched;
 }
 
 @end
@@ -46,12 +46,15 @@ NS_ASSUME_NONNULL_BEGIN
 	BOOL _isEventOnlyMessage;
 	BOOL _isPrintOnlyMessage;
 	IRCPrefix *_sender;
-	NSArray<NSString *> *_params;
+	void * _Nullable _Atomic _params; // NSArray<NSString *>, published by -params
 	NSDate *_receivedAt;
 	NSDictionary<NSString *, NSString *> *_messageTags;
 	NSString *_batchToken;
 	NSString *_command;
 	NSUInteger _commandNumeric;
+	IRCRemoteCommand _remoteCommand;
+	NSString *_paramsLine;
+	NSUInteger _paramsLineLocation;
 	IRCMessageBatchMessage *_parentBatchMessage;
 }
 
@@ -59,8 +62,21 @@ NS_ASSUME_NONNULL_BEGIN
 
 @interface IRCMessage (IRCMessageLineParser)
 - (BOOL)parseLine:(NSString *)line forClient:(nullable IRCClient *)client;
-- (void)parseExtensions:(NSString *)extensionInfo forClient:(nullable IRCClient *)client;
+- (void)parseExtensionsInRange:(NSRange)extensionRange ofLine:(NSString *)line forClient:(nullable IRCClient *)client;
 - (void)parseSender:(NSString *)senderInfo forClient:(nullable IRCClient *)client;
+- (void)parseCommandInRange:(NSRange)commandRange ofLine:(NSString *)line;
+- (NSArray<NSString *> *)parseParamsInLine:(NSString *)line fromLocation:(NSUInteger)location;
+@end
+
+/* Splits the sender of a message into its parts. Used by -parseSender:forClient:
+ and by IRCPrefixCache so that there is only one way a sender is parsed. */
+TEXTUAL_EXTERN IRCPrefix *IRCMessageParseSender(NSString *senderInfo, IRCClient * _Nullable client);
+
+/* IRCMessageTags is the dictionary stored in -messageTags
+ when a message is parsed. It keeps the raw tag section of
+ the line and only decodes the value of a key when asked. */
+@interface IRCMessageTags : NSDictionary<NSString *, NSString *>
+- (instancetype)initWithLine:(NSString *)line range:(NSRange)range;
 @end
 
 NS_ASSUME_NONNULL_END
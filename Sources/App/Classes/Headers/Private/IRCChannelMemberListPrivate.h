@@ -39,11 +39,20 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class IRCChannel, IRCChannelMemberListController;
+@class IRCChannel, IRCChannelMemberListController, IRCChannelNicknameScanner;
 
 @protocol IRCChannelMemberListPrivatePrototype <NSObject>
 - (void)addMember:(IRCChannelUser *)member checkForDuplicates:(BOOL)checkForDuplicates;
 
+/* Staged members are not part of -memberList until they are committed.
+ -commitStagedMembers sorts them into the member list in one pass. */
+- (void)stageMembers:(NSArray<IRCChannelUser *> *)members;
+- (void)commitStagedMembers;
+
+/* Removes members in one pass and updates the member list view once.
+ This is used when a large number of users leave at the same time. */
+- (void)removeMembers:(NSArray<IRCChannelUser *> *)members;
+
 /* The replaceInAllChannels: flag should only be used in extreme cases because there is A LOT
  of overhead to setting it. Textual only does it when the user list is configured to sort IRCop
  at top and IRCop status changes. That change requires the user to be resorted in every channel
@@ -67,6 +76,8 @@ NS_ASSUME_NONNULL_BEGIN
 @interface IRCChannelMemberList () <IRCChannelMemberListPrivatePrototype>
 - (instancetype)initWithChannel:(IRCChannel *)channel NS_DESIGNATED_INITIALIZER;
 
+@property (readonly) IRCChannelNicknameScanner *nicknameScanner;
+
 + (void)suspendMemberListSerialQueues;
 + (void)resumeMemberListSerialQueues;
 @end
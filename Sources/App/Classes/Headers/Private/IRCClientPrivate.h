@@ -40,8 +40,8 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class TLOSpokenNotification;
-@class IRCAddressBookUserTrackingContainer, IRCTimedCommand, IRCUserMutable;
+@class TLOSpokenNotification, TLOTimerWheel;
+@class IRCAddressBookUserTrackingContainer, IRCPrefixCache, IRCTimedCommand, IRCUserMutable;
 
 enum {
 	ClientIRCv3SupportedCapabilitySASLGeneric			= 1 << 22,
@@ -60,6 +60,9 @@ enum {
 @property (nonatomic, assign) BOOL sidebarItemIsExpanded;
 @property (nonatomic, copy, readwrite) NSArray<IRCChannel *> *channelList;
 @property (nonatomic, weak, readwrite) IRCChannel *lastSelectedChannel;
+@property (nonatomic, strong, readonly) IRCPrefixCache *prefixCache;
+@property (nonatomic, strong, readonly) TLOTimerWheel *timerWheel;
+@property (nonatomic, assign) BOOL isReplayingTraffic; // YES while /replay is feeding a capture through the client
 
 - (instancetype)initWithConfig:(IRCClientConfig *)config NS_DESIGNATED_INITIALIZER;
 - (instancetype)initWithConfigDictionary:(NSDictionary<NSString *, id> *)dic;
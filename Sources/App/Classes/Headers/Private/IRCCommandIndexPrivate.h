@@ -45,4 +45,11 @@ NS_ASSUME_NONNULL_BEGIN
 + (void)invalidateCaches;
 @end
 
+/* Returns NSNotFound if the command is unknown. Characters
+ must already be uppercase ASCII for a match to occur. */
+TEXTUAL_EXTERN IRCRemoteCommand IRCRemoteCommandFromCharacters(const unichar *characters, NSUInteger length);
+
+/* Same as above but folds the case of the command first. */
+TEXTUAL_EXTERN IRCRemoteCommand IRCRemoteCommandFromString(NSString *command);
+
 NS_ASSUME_NONNULL_END
@@ -53,6 +53,11 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)enforceFloodControl;
 
+/* Lines sent using this method may be sent after lines sent
+ using -sendLine: even if they were given first. It is meant
+ for requests the user did not make such as WHO polling. */
+- (void)sendLineInBackground:(NSString *)line;
+
 - (void)openSecuredConnectionCertificateModal;
 @end
 
@@ -45,10 +45,18 @@ NS_ASSUME_NONNULL_BEGIN
 @property (readonly, weak) IRCChannel *channel;
 @property (readonly, copy) NSString *channelName;
 @property (readonly, copy) NSString *timeLoggedFormatted;
+
+/* An entry only points to its line in the historic log which means
+ -lineLogged is a placeholder until it is fetched. Lines which are not
+ written to the historic log, such as those of encrypted channels, are
+ kept. -renderedMessage changes when the fetch completes. */
+- (void)fetchLineLoggedIfNeeded;
 @end
 
 @interface IRCHighlightLogEntryMutable : IRCHighlightLogEntry
 @property (nonatomic, copy, readwrite) TVCLogLine *lineLogged;
+@property (nonatomic, copy, readwrite) NSDate *timeLogged;
+@property (nonatomic, copy, readwrite) NSString *lineNumber;
 @property (nonatomic, copy, readwrite) NSString *clientId;
 @property (nonatomic, copy, readwrite) NSString *channelId;
 @end
@@ -55,4 +55,20 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)reset;
 @end
 
+/* Folds the case of characters in string according to caseMapping into buffer.
+ Returns the number of characters written or NSNotFound if bufferLength is too short.
+ The Unicode case mapping only folds ASCII characters when using this function. */
+TEXTUAL_EXTERN NSUInteger IRCISupportInfoFoldString(IRCISupportInfoCaseMapping caseMapping, NSString *string, unichar *buffer, NSUInteger bufferLength);
+
+/* Hash and compare strings according to caseMapping without allocating
+ memory, except for strings with non-ASCII characters compared using the
+ Unicode case mapping, which are lowercased the same way as NSString does. */
+TEXTUAL_EXTERN NSUInteger IRCISupportInfoHashString(IRCISupportInfoCaseMapping caseMapping, NSString *string);
+TEXTUAL_EXTERN BOOL IRCISupportInfoStringsAreEqual(IRCISupportInfoCaseMapping caseMapping, NSString *string1, NSString *string2);
+
+/* Creates a dictionary with string keys which are hashed
+ and compared using IRCISupportInfoHashString() and
+ IRCISupportInfoStringsAreEqual() for caseMapping. */
+TEXTUAL_EXTERN NSMutableDictionary *IRCISupportInfoCreateCaseMappedDictionary(IRCISupportInfoCaseMapping caseMapping);
+
 NS_ASSUME_NONNULL_END
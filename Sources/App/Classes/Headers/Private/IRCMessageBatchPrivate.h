@@ -57,6 +57,7 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign) BOOL batchIsOpen;
 @property (nonatomic, copy) NSString *batchToken;
 @property (nonatomic, copy, nullable) NSString *batchType;
+@property (nonatomic, copy, nullable) NSArray<NSString *> *batchParameters; // Parameters after the type
 @property (readonly, copy) NSArray *queuedEntries;
 @property (nonatomic, weak) IRCMessageBatchMessage *parentBatchMessage;
 
@@ -35,6 +35,7 @@
  *
  *********************************************************************** */
 
+#import "IRCCommandIndex.h"
 #import "IRCMessage.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -44,6 +45,10 @@ NS_ASSUME_NONNULL_BEGIN
 @interface IRCMessage ()
 @property (readonly, strong, nullable) IRCMessageBatchMessage *parentBatchMessage;
 
+/* The value of -command resolved against IRCCommandIndex when the
+ message was parsed. NSNotFound for numerics and unknown commands. */
+@property (readonly) IRCRemoteCommand remoteCommand;
+
 - (void)markAsNotHistoric;
 @end
 
@@ -0,0 +1,76 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+NS_ASSUME_NONNULL_BEGIN
+
+@class IRCChannel, IRCChannelUser;
+
+typedef NS_ENUM(NSUInteger, IRCNetsplitType)
+{
+	IRCNetsplitTypeSplit = 0,
+	IRCNetsplitTypeJoin
+};
+
+/* IRCNetsplit collects the users that leave when two servers split,
+ or that return when they rejoin, so that each channel can be updated
+ in one pass and be told about it with one line instead of thousands. */
+@interface IRCNetsplit : NSObject
+@property (readonly) IRCNetsplitType type;
+@property (readonly, copy) NSString *servers; // "server1 server2"
+@property (readonly, copy) NSDate *receivedAt;
+
+- (instancetype)init NS_UNAVAILABLE;
+- (instancetype)initWithType:(IRCNetsplitType)type servers:(NSString *)servers receivedAt:(NSDate *)receivedAt NS_DESIGNATED_INITIALIZER;
+
+/* Channels are returned in the order they were first added to */
+@property (readonly, copy) NSArray<IRCChannel *> *channels;
+
+- (void)addMember:(IRCChannelUser *)member toChannel:(IRCChannel *)channel;
+- (void)addNicknameToPrint:(NSString *)nickname inChannel:(IRCChannel *)channel;
+
+- (NSArray<IRCChannelUser *> *)membersInChannel:(IRCChannel *)channel;
+- (NSArray<NSString *> *)nicknamesToPrintInChannel:(IRCChannel *)channel;
+
+@property (readonly, copy) NSString *firstServer;
+@property (readonly, copy) NSString *secondServer;
+
+/* Servers send "server1 server2" as the quit message of each user
+ lost in a netsplit. Returns the comment if it is in that format. */
++ (nullable NSString *)serversInQuitComment:(NSString *)comment;
+@end
+
+NS_ASSUME_NONNULL_END
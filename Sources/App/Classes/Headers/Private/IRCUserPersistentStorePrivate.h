@@ -41,11 +41,12 @@ NS_ASSUME_NONNULL_BEGIN
  properties which are persistent between multiple read-only 
  and mutable copies of the same IRCUser instance. */
 @class IRCUserRelations;
+@class TLOTimerWheelEntry;
 
 @interface IRCUserPersistentStore : NSObject
 @property (nonatomic, strong) IRCUserRelations *relations;
 @property (nonatomic, assign) CFAbsoluteTime presentAwayMessageFor301LastEvent;
-@property (nonatomic, strong) dispatch_source_t removeUserTimer;
+@property (nonatomic, strong, nullable) TLOTimerWheelEntry *removeUserTimer;
 @end
 
 NS_ASSUME_NONNULL_END
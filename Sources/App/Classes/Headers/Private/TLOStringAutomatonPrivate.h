@@ -0,0 +1,65 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+NS_ASSUME_NONNULL_BEGIN
+
+/* TLOStringAutomaton is an Aho-Corasick automaton that finds every
+ occurrence of any number of strings in one pass over the characters
+ searched, no matter how many strings were added to it. */
+/* Strings are matched literally. To match without regard to case, fold
+ the strings added and the strings searched in the same way. */
+/* Like -enumerateMatchesOfString:, an occurrence which overlaps the
+ previous occurrence of the same string is not reported. */
+/* Adding strings is not thread safe. After -prepare is called,
+ any number of threads may search at the same time, as long
+ as no more strings are added. */
+@interface TLOStringAutomaton : NSObject
+@property (readonly) NSUInteger numberOfStrings;
+
+/* Returns the index of the string which is reported when it is
+ found. Adding a string that was already added returns its index. */
+- (NSUInteger)addString:(NSString *)string;
+
+- (NSUInteger)lengthOfStringAtIndex:(NSUInteger)index;
+
+- (void)prepare; // Called by search methods if needed
+
+- (void)enumerateMatchesInString:(NSString *)string withBlock:(void (NS_NOESCAPE ^)(NSUInteger stringIndex, NSRange range))block;
+@end
+
+NS_ASSUME_NONNULL_END
@@ -45,6 +45,7 @@ NS_ASSUME_NONNULL_BEGIN
 + (TVCLogControllerHistoricLogFile *)sharedInstance;
 
 - (void)writeNewEntryWithLogLine:(TVCLogLine *)logLine forItem:(IRCTreeItem *)item;
+- (void)writeNewEntriesWithLogLines:(NSArray<TVCLogLine *> *)logLines forItem:(IRCTreeItem *)item;
 
 - (void)saveData; // asynchronous operation
 
@@ -51,6 +51,23 @@ typedef void (^TVCLogControllerPrintingBlock)(NSOperation *sender);
 - (void)cancelOperationsForViewController:(TVCLogController *)viewController;
 
 - (void)updateReadinessState:(TVCLogController *)viewController;
+
+/* Blocks the calling thread while too many lines of the client are
+ waiting to be rendered in loaded views, for no longer than a second.
+ Does nothing on the main thread. */
+- (void)waitForRenderBudgetForClient:(IRCClient *)client;
+
+/* Blocks the calling thread until no lines of the client are waiting
+ to be rendered in loaded views, for no longer than a minute.
+ Does nothing on the main thread. */
+- (void)waitUntilLinesAreRenderedForClient:(IRCClient *)client;
+
+/* Statistics for lanes since they were last reset. Used by the
+ traffic replay to measure how rendering scales across workers. */
+@property (readonly) NSUInteger peakNumberOfLanesDraining; // Most views rendered at the same time
+@property (readonly) CFAbsoluteTime timeSpentDrainingLanes; // Rendering time summed across all workers
+
+- (void)resetLaneStatistics;
 @end
 
 NS_ASSUME_NONNULL_END
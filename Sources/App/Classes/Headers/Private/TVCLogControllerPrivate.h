@@ -60,6 +60,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)print:(TVCLogLine *)logLine;
 - (void)print:(TVCLogLine *)logLine completionBlock:(nullable TVCLogControllerPrintOperationCompletionBlock)completionBlock;
 
+/* Lines printed during a transaction are rendered and
+ appended to the view together when the transaction ends.
+ Transactions can be nested. Only the outermost one prints. */
+- (void)beginPrintTransaction;
+- (void)endPrintTransaction;
+
 - (void)renderLogLineAtLineNumber:(NSString *)lineNumber
 			  numberOfLinesBefore:(NSUInteger)numberOfLinesBefore
 			   numberOfLinesAfter:(NSUInteger)numberOfLinesAfter
@@ -0,0 +1,65 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "TPCPreferencesLocal.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/* TVCLogRendererKeywordMatcher is a list of highlight keywords and
+ excluded keywords compiled for the matching method they are used with.
+ Keywords are matched using a single TLOStringAutomaton pass for exact
+ and partial matching. Regular expressions are compiled only once. */
+/* A matcher is immutable once created and is shared by all renderers
+ which use the same keywords. It is safe to use from any thread. */
+@interface TVCLogRendererKeywordMatcher : NSObject
+@property (readonly) TXNicknameHighlightMatchType matchingMethod;
+
+/* Returns a matcher from cache or compiles a new one */
++ (instancetype)matcherForHighlightKeywords:(NSArray<NSString *> *)highlightKeywords
+						   excludedKeywords:(nullable NSArray<NSString *> *)excludedKeywords
+							 matchingMethod:(TXNicknameHighlightMatchType)matchingMethod;
+
+/* The block is offered each occurrence of a highlight keyword that does
+ not intersect an occurrence of an excluded keyword. Occurrences are
+ offered in the order of the keywords, then in order of location.
+ A regular expression only offers its first match. */
+/* The block returns YES to accept the occurrence which stops enumeration. */
+- (void)enumerateKeywordsInString:(NSString *)string withBlock:(BOOL (NS_NOESCAPE ^)(NSRange range))block;
+@end
+
+NS_ASSUME_NONNULL_END
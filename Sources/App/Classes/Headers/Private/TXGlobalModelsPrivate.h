@@ -41,4 +41,6 @@ NS_ASSUME_NONNULL_BEGIN
 
 TEXTUAL_EXTERN NSDateFormatter *TXSharedISOStandardDateFormatter(void);
 
+TEXTUAL_EXTERN BOOL TXParseISOStandardDateString(NSString *dateString, NSTimeInterval *timeInterval);
+
 NS_ASSUME_NONNULL_END
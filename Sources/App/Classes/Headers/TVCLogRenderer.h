@@ -84,6 +84,12 @@ TEXTUAL_EXTERN TVCLogRendererResultsAttribute const TVCLogRendererResultsOrigina
 	   forViewController:(TVCLogController *)viewController
 		  withAttributes:(NSDictionary<TVCLogRendererConfigurationAttribute, id> *)inputDictionary
 			  resultInfo:(NSDictionary<TVCLogRendererResultsAttribute, id> * _Nullable * _Nullable)outputDictionary;
+
+/* Returns the same results as -renderBody:forViewController:withAttributes:resultInfo:
+ without rendering HTML. Used for lines which are not going to be displayed right away. */
++ (NSDictionary<TVCLogRendererResultsAttribute, id> *)matchBody:(NSString *)body
+											 forViewController:(TVCLogController *)viewController
+												withAttributes:(NSDictionary<TVCLogRendererConfigurationAttribute, id> *)inputDictionary;
 @end
 
 NS_ASSUME_NONNULL_END
@@ -95,6 +95,7 @@
 	#import "TLOLocalization.h"
 	#import "TLOSoundPlayer.h"
 	#import "TLOTimer.h"
+	#import "TLOTimerWheel.h"
 	#import "TLOpenLink.h"
 
 	/* Preferences */
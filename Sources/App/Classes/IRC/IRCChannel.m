@@ -565,7 +565,7 @@ NSString * const IRCChannelConfigurationWasUpdatedNotification = @"IRCChannelCon
 {
 	NSParameterAssert(logLine != nil);
 
-	if (self.isUtility || [TPCPreferences logToDiskIsEnabled] == NO) {
+	if (self.isUtility || [TPCPreferences logToDiskIsEnabled] == NO || self.associatedClient.isReplayingTraffic) {
 		return;
 	}
 
@@ -615,6 +615,21 @@ NSString * const IRCChannelConfigurationWasUpdatedNotification = @"IRCChannelCon
 	[self.memberInfo addMember:member checkForDuplicates:checkForDuplicates];
 }
 
+- (void)stageMembers:(NSArray<IRCChannelUser *> *)members
+{
+	[self.memberInfo stageMembers:members];
+}
+
+- (void)commitStagedMembers
+{
+	[self.memberInfo commitStagedMembers];
+}
+
+- (void)removeMembers:(NSArray<IRCChannelUser *> *)members
+{
+	[self.memberInfo removeMembers:members];
+}
+
 - (void)removeMemberWithNickname:(NSString *)nickname
 {
 	[self.memberInfo removeMemberWithNickname:nickname];
@@ -40,6 +40,7 @@
 #import "IRCChannelPrivate.h"
 #import "IRCChannelMemberListPrivate.h"
 #import "IRCChannelMemberListControllerPrivate.h"
+#import "IRCChannelNicknameScannerPrivate.h"
 #import "IRCChannelUserPrivate.h"
 #import "IRCISupportInfo.h"
 #import "IRCUserRelationsPrivate.h"
@@ -57,8 +58,15 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, weak) IRCChannel *channel;
 @property (nonatomic, strong, nullable) IRCChannelMemberListController *controller;
 @property (nonatomic, strong) NSMutableArray<IRCChannelUser *> *memberContainer;
+@property (nonatomic, strong, nullable) NSMutableArray<IRCChannelUser *> *stagedMemberContainer;
+@property (copy, nullable) NSArray<IRCChannelUser *> *memberContainerSnapshot; // atomic; nil when stale
+@property (assign) NSUInteger memberContainerCount; // atomic
+@property (nonatomic, strong) dispatch_queue_t modifyMemberListSerialQueue;
+@property (nonatomic, strong, readwrite) IRCChannelNicknameScanner *nicknameScanner;
 @end
 
+static void *IsOnWorkerQueueKey = &IsOnWorkerQueueKey;
+
 @implementation IRCChannelMemberList
 
 - (instancetype)init
@@ -87,6 +95,12 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)prepareInitialState
 {
 	self.memberContainer = [NSMutableArray array];
+
+	self.memberContainerSnapshot = @[];
+
+	self.nicknameScanner = [IRCChannelNicknameScanner new];
+
+	[self createMemberListSerialQueue];
 }
 
 - (void)dealloc
@@ -122,54 +136,60 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark -
 #pragma mark Grand Central Dispatch
 
-/* All modifications to the member list occur on this serial queue
- to guarantee that there is only ever one person accessing the mutable
- store at any given time. */
-+ (dispatch_queue_t)modifyMemberListSerialQueue
+/* Each member list has its own serial queue on which all modifications
+ occur to guarantee that there is only ever one person accessing the
+ mutable store at any given time. Changes to one channel do not wait
+ on changes to another channel. */
+/* Every serial queue targets a shared concurrent queue. The shared
+ queue is suspended during termination to stop all modifications. */
++ (dispatch_queue_t)memberListTargetQueue
 {
-	static dispatch_queue_t workerQueue = NULL;
+	static dispatch_queue_t targetQueue = NULL;
 
 	static dispatch_once_t onceToken;
 
 	dispatch_once(&onceToken, ^{
-		workerQueue =
-		XRCreateDispatchQueueWithPriority("IRCChannel.modifyMemberListSerialQueue", DISPATCH_QUEUE_SERIAL, QOS_CLASS_DEFAULT);
+		targetQueue =
+		XRCreateDispatchQueueWithPriority("IRCChannel.memberListTargetQueue", DISPATCH_QUEUE_CONCURRENT, QOS_CLASS_DEFAULT);
 	});
 
-	return workerQueue;
+	return targetQueue;
 }
 
 + (void)resumeMemberListSerialQueues
 {
-	dispatch_resume([self modifyMemberListSerialQueue]);
+	dispatch_resume([self memberListTargetQueue]);
 }
 
 + (void)suspendMemberListSerialQueues
 {
-	dispatch_suspend([self modifyMemberListSerialQueue]);
+	dispatch_suspend([self memberListTargetQueue]);
 }
 
-+ (void)accessMemberListUsingBlock:(dispatch_block_t)block
+- (void)createMemberListSerialQueue
 {
-	NSCParameterAssert(block != NULL);
+	dispatch_queue_t workerQueue =
+	XRCreateDispatchQueueWithPriority("IRCChannel.modifyMemberListSerialQueue", DISPATCH_QUEUE_SERIAL, QOS_CLASS_DEFAULT);
 
-	dispatch_queue_t workerQueue = [self modifyMemberListSerialQueue];
+	dispatch_set_target_queue(workerQueue, [self.class memberListTargetQueue]);
 
-	static void *IsOnWorkerQueueKey = NULL;
+	/* The context is not retained. It is only compared against. */
+	dispatch_queue_set_specific(workerQueue, IsOnWorkerQueueKey, (__bridge void *)self, NULL);
 
-	if (IsOnWorkerQueueKey == NULL) {
-		IsOnWorkerQueueKey = &IsOnWorkerQueueKey;
+	self.modifyMemberListSerialQueue = workerQueue;
+}
 
-		dispatch_queue_set_specific(workerQueue, IsOnWorkerQueueKey, (void *)1, NULL);
-	}
+- (void)accessMemberListUsingBlock:(dispatch_block_t)block
+{
+	NSParameterAssert(block != NULL);
 
-	if (dispatch_get_specific(IsOnWorkerQueueKey)) {
+	if (dispatch_get_specific(IsOnWorkerQueueKey) == (__bridge void *)self) {
 		block();
 
 		return;
 	}
 
-	dispatch_sync(workerQueue, ^{
+	dispatch_sync(self.modifyMemberListSerialQueue, ^{
 		@autoreleasepool {
 			block();
 		}
@@ -194,6 +214,49 @@ NS_ASSUME_NONNULL_BEGIN
 	return index;
 }
 
+/* The member container is sorted which means a member can usually
+ be found with a binary search instead of comparing against every
+ member in the channel. A member's position can become stale when
+ something its rank depends on changes without the member being
+ resorted, such as ISUPPORT or preferences. The container is then
+ searched from start to end, as it was before. */
+- (NSUInteger)nonatomic_indexOfMember:(IRCChannelUser *)member
+{
+	NSParameterAssert(member != nil);
+
+	NSMutableArray *container = self.memberContainer;
+
+	NSComparator comparator = [IRCChannelUser channelRankComparator];
+
+	NSUInteger index = [container
+							indexOfObject:member
+							inSortedRange:container.range
+								  options:NSBinarySearchingFirstEqual
+						  usingComparator:comparator];
+
+	if (index != NSNotFound) {
+		NSUInteger containerCount = container.count;
+
+		/* Distinct members only compare the same when they
+		 have the same rank and their nicknames differ by case. */
+		while (index < containerCount) {
+			IRCChannelUser *memberAtIndex = container[index];
+
+			if (memberAtIndex == member) {
+				return index;
+			}
+
+			if (comparator(memberAtIndex, member) != NSOrderedSame) {
+				break;
+			}
+
+			index += 1;
+		}
+	}
+
+	return [container indexOfObjectIdenticalTo:member];
+}
+
 - (NSInteger)nonatomic_sortedInsert:(IRCChannelUser *)member
 {
 	NSParameterAssert(member != nil);
@@ -202,6 +265,8 @@ NS_ASSUME_NONNULL_BEGIN
 
 	[self.memberContainer insertObject:member atIndex:insertedIndex];
 
+	[self.nicknameScanner addMember:member];
+
 	return insertedIndex;
 }
 
@@ -212,14 +277,19 @@ NS_ASSUME_NONNULL_BEGIN
 
 	NSMutableArray *container = self.memberContainer;
 
-	NSUInteger index = [container indexOfObjectIdenticalTo:member1];
+	NSUInteger index = [self nonatomic_indexOfMember:member1];
 
 	if (index == NSNotFound) {
+		[self nonatomic_replaceStagedMember:member1 withMember:member2];
+
 		return (-1);
 	}
 
 	container[index] = member2;
 
+	[self.nicknameScanner removeMember:member1];
+	[self.nicknameScanner addMember:member2];
+
 	return index;
 }
 
@@ -229,17 +299,61 @@ NS_ASSUME_NONNULL_BEGIN
 
 	NSMutableArray *container = self.memberContainer;
 
-	NSUInteger index = [container indexOfObjectIdenticalTo:member];
+	NSUInteger index = [self nonatomic_indexOfMember:member];
 
 	if (index == NSNotFound) {
+		[self nonatomic_replaceStagedMember:member withMember:nil];
+
 		return (-1);
 	}
 
 	[container removeObjectAtIndex:index];
 
+	[self.nicknameScanner removeMember:member];
+
 	return index;
 }
 
+/* Readers are given an immutable copy of the member list. A change
+ only throws away the last copy so that a burst of changes to a large
+ channel does not copy the member list for each of them. The copy is
+ made on the serial queue by the first reader after a change and then
+ shared, without waiting on the queue, until the next change.
+ The nonatomic_ methods which modify the member list do not call this
+ so that a change made up of several of them is published once. */
+- (void)nonatomic_memberContainerChanged
+{
+	self.memberContainerSnapshot = nil;
+
+	self.memberContainerCount = self.memberContainer.count;
+}
+
+/* A member that changes or leaves before the staged members are
+ committed must be changed in, or removed from, the staging area
+ so that the old member isn't added when the commit happens. */
+- (void)nonatomic_replaceStagedMember:(IRCChannelUser *)member1 withMember:(nullable IRCChannelUser *)member2
+{
+	NSParameterAssert(member1 != nil);
+
+	NSMutableArray *stagedContainer = self.stagedMemberContainer;
+
+	if (stagedContainer == nil) {
+		return;
+	}
+
+	NSUInteger index = [stagedContainer indexOfObjectIdenticalTo:member1];
+
+	if (index == NSNotFound) {
+		return;
+	}
+
+	if (member2) {
+		stagedContainer[index] = member2;
+	} else {
+		[stagedContainer removeObjectAtIndex:index];
+	}
+}
+
 #pragma mark -
 #pragma mark Frontend Operations
 
@@ -284,8 +398,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 	__block NSInteger sortedIndex = (-1);
 
-	[self.class accessMemberListUsingBlock:^{
+	[self accessMemberListUsingBlock:^{
 		sortedIndex = [self nonatomic_sortedInsert:member];
+
+		[self nonatomic_memberContainerChanged];
 	}];
 
 	[self didChangeValueForKey:@"numberOfMembers"];
@@ -306,6 +422,159 @@ NS_ASSUME_NONNULL_BEGIN
 	});
 }
 
+/* Members received in a NAMES reply are added in bulk. Adding each
+ member as it arrives costs a sorted insert, KVO notifications, and
+ a trip to the main thread to update the member list view. That adds
+ up to seconds when joining a channel with thousands of members.
+ Instead, members are held in a staging area until the end of the
+ reply, at which point they are sorted and shown all at once. */
+/* Staged members are associated with the channel right away
+ so that -findMember: and duplicate checks are aware of them. */
+- (void)stageMembers:(NSArray<IRCChannelUser *> *)members
+{
+	NSParameterAssert(members != nil);
+
+	IRCChannel *channel = self.channel;
+
+	NSMutableArray<IRCChannelUser *> *membersToStage = [NSMutableArray arrayWithCapacity:members.count];
+
+	for (IRCChannelUser *memberIn in members) {
+		IRCChannelUser *member = memberIn;
+
+		IRCChannelUser *oldMember = [member.user userAssociatedWithChannel:channel];
+
+		if (oldMember != nil) {
+			[self replaceMember:oldMember withMember:member];
+
+			continue;
+		}
+
+		if ([member isKindOfClass:[IRCChannelUserMutable class]]) {
+			 member = [member copy];
+		}
+
+		[member associateWithChannel:channel];
+
+		[membersToStage addObject:member];
+	}
+
+	if (membersToStage.count == 0) {
+		return;
+	}
+
+	[self accessMemberListUsingBlock:^{
+		NSMutableArray *stagedContainer = self.stagedMemberContainer;
+
+		if (stagedContainer == nil) {
+			self.stagedMemberContainer = membersToStage;
+		} else {
+			[stagedContainer addObjectsFromArray:membersToStage];
+		}
+	}];
+}
+
+/* Staged members are merged without creating duplicates. A member is
+ skipped if its user is already in the member list or was staged more
+ than once, which can happen when a netjoin reuses a user, or if the
+ user is no longer associated with the channel through that member. */
+- (void)commitStagedMembers
+{
+	IRCChannel *channel = self.channel;
+
+	__block BOOL membersCommitted = NO;
+
+	[self willChangeValueForKey:@"numberOfMembers"];
+	[self willChangeValueForKey:@"memberList"];
+
+	[self accessMemberListUsingBlock:^{
+		NSMutableArray *stagedContainer = self.stagedMemberContainer;
+
+		if (stagedContainer == nil) {
+			return;
+		}
+
+		self.stagedMemberContainer = nil;
+
+		NSMutableArray *container = self.memberContainer;
+
+		NSHashTable<IRCUser *> *users = [[NSHashTable alloc] initWithOptions:NSPointerFunctionsObjectPointerPersonality capacity:(container.count + stagedContainer.count)];
+
+		for (IRCChannelUser *member in container) {
+			[users addObject:member.user];
+		}
+
+		NSMutableArray<IRCChannelUser *> *membersToCommit = [NSMutableArray arrayWithCapacity:stagedContainer.count];
+
+		for (IRCChannelUser *member in stagedContainer) {
+			IRCUser *user = member.user;
+
+			if ([users containsObject:user] || [user userAssociatedWithChannel:channel] != member) {
+				continue;
+			}
+
+			[users addObject:user];
+
+			[membersToCommit addObject:member];
+		}
+
+		if (membersToCommit.count == 0) {
+			return;
+		}
+
+		[container addObjectsFromArray:membersToCommit];
+
+		[container sortUsingComparator:[IRCChannelUser channelRankComparator]];
+
+		[self.nicknameScanner addMembers:membersToCommit];
+
+		[self nonatomic_memberContainerChanged];
+
+		membersCommitted = YES;
+	}];
+
+	[self didChangeValueForKey:@"numberOfMembers"];
+	[self didChangeValueForKey:@"memberList"];
+
+	if (membersCommitted == NO || channel.isChannel == NO) {
+		return;
+	}
+
+	XRPerformBlockSynchronouslyOnMainQueue(^{
+		__weak IRCChannelMemberListController *controller = self.controller;
+
+		if ( controller != nil) {
+			[controller replaceContents:self.memberList];
+		}
+
+		[self.client postEventToViewController:@"channelMemberAdded" forChannel:channel];
+	});
+}
+
+/* Staged members are held until the end of a NAMES reply or a netjoin.
+ If the channel is left before then, they must not linger as members. */
+- (void)discardStagedMembers
+{
+	IRCChannel *channel = self.channel;
+
+	[self accessMemberListUsingBlock:^{
+		NSMutableArray *stagedContainer = self.stagedMemberContainer;
+
+		if (stagedContainer == nil) {
+			return;
+		}
+
+		self.stagedMemberContainer = nil;
+
+		for (IRCChannelUser *member in stagedContainer) {
+			if ([member.user userAssociatedWithChannel:channel] != member) {
+				continue;
+			}
+
+			[member disassociateWithChannel:channel];
+		}
+	}];
+}
+
 - (void)removeMemberWithNickname:(NSString *)nickname
 {
 	NSParameterAssert(nickname != nil);
@@ -327,8 +596,12 @@ NS_ASSUME_NONNULL_BEGIN
 
 	__block NSInteger sortedIndex = (-1);
 
-	[self.class accessMemberListUsingBlock:^{
+	[self accessMemberListUsingBlock:^{
 		sortedIndex = [self nonatomic_removeMember:member];
+
+		if (sortedIndex >= 0) {
+			[self nonatomic_memberContainerChanged];
+		}
 	}];
 
 	if (sortedIndex < 0 || channel.isChannel == NO) {
@@ -346,6 +619,69 @@ NS_ASSUME_NONNULL_BEGIN
 	});
 }
 
+- (void)removeMembers:(NSArray<IRCChannelUser *> *)members
+{
+	NSParameterAssert(members != nil);
+
+	if (members.count == 0) {
+		return;
+	}
+
+	IRCChannel *channel = self.channel;
+
+	[members makeObjectsPerformSelector:@selector(disassociateWithChannel:) withObject:channel];
+
+	__block BOOL membersRemoved = NO;
+
+	[self willChangeValueForKey:@"numberOfMembers"];
+	[self willChangeValueForKey:@"memberList"];
+
+	[self accessMemberListUsingBlock:^{
+		NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+
+		for (IRCChannelUser *member in members) {
+			NSUInteger index = [self nonatomic_indexOfMember:member];
+
+			if (index == NSNotFound) {
+				[self nonatomic_replaceStagedMember:member withMember:nil];
+
+				continue;
+			}
+
+			[indexes addIndex:index];
+
+			[self.nicknameScanner removeMember:member];
+		}
+
+		if (indexes.count == 0) {
+			return;
+		}
+
+		[self.memberContainer removeObjectsAtIndexes:indexes];
+
+		[self nonatomic_memberContainerChanged];
+
+		membersRemoved = YES;
+	}];
+
+	[self didChangeValueForKey:@"numberOfMembers"];
+	[self didChangeValueForKey:@"memberList"];
+
+	if (membersRemoved == NO || channel.isChannel == NO) {
+		return;
+	}
+
+	XRPerformBlockSynchronouslyOnMainQueue(^{
+		__weak IRCChannelMemberListController *controller = self.controller;
+
+		if ( controller != nil) {
+			[controller replaceContents:self.memberList];
+		}
+
+		[self.client postEventToViewController:@"channelMemberRemoved" forChannel:channel];
+	});
+}
+
 - (void)resortMember:(IRCChannelUser *)member
 {
 	NSParameterAssert(member != nil);
@@ -373,7 +709,7 @@ NS_ASSUME_NONNULL_BEGIN
 	__block NSInteger oldIndex = (-1);
 	__block NSInteger newIndex = (-1);
 
-	[self.class accessMemberListUsingBlock:^{
+	[self accessMemberListUsingBlock:^{
 		if (resort) {
 			oldIndex = [self nonatomic_removeMember:member1];
 
@@ -381,6 +717,10 @@ NS_ASSUME_NONNULL_BEGIN
 		} else {
 			newIndex = [self nonatomic_replaceMember:member1 withMember:member2];
 		}
+
+		if (oldIndex >= 0 || newIndex >= 0) {
+			[self nonatomic_memberContainerChanged];
+		}
 	}];
 
 	if (newIndex < 0 || channel.isChannel == NO) {
@@ -548,8 +888,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)sortMembers
 {
-	[self.class accessMemberListUsingBlock:^{
+	[self accessMemberListUsingBlock:^{
 		[self.memberContainer sortUsingComparator:[IRCChannelUser channelRankComparator]];
+
+		[self nonatomic_memberContainerChanged];
 	}];
 
 	XRPerformBlockSynchronouslyOnMainQueue(^{
@@ -567,18 +909,24 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	IRCChannel *channel = self.channel;
 
-	[self.class accessMemberListUsingBlock:^{
-		[self willChangeValueForKey:@"numberOfMembers"];
-		[self willChangeValueForKey:@"memberList"];
+	[self discardStagedMembers];
+
+	[self willChangeValueForKey:@"numberOfMembers"];
+	[self willChangeValueForKey:@"memberList"];
 
+	[self accessMemberListUsingBlock:^{
 		[self.memberContainer makeObjectsPerformSelector:@selector(disassociateWithChannel:) withObject:channel];
 
 		[self.memberContainer removeAllObjects];
 
-		[self didChangeValueForKey:@"numberOfMembers"];
-		[self didChangeValueForKey:@"memberList"];
+		[self.nicknameScanner removeAllMembers];
+
+		[self nonatomic_memberContainerChanged];
 	}];
 
+	[self didChangeValueForKey:@"numberOfMembers"];
+	[self didChangeValueForKey:@"memberList"];
+
 	XRPerformBlockSynchronouslyOnMainQueue(^{
 		__weak IRCChannelMemberListController *controller = self.controller;
 
@@ -592,21 +940,27 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (NSUInteger)numberOfMembers
 {
-	__block NSUInteger memberCount = 0;
-
-	[self.class accessMemberListUsingBlock:^{
-		memberCount = self.memberContainer.count;
-	}];
-
-	return memberCount;
+	return self.memberContainerCount;
 }
 
 - (nullable NSArray<IRCChannelUser *> *)memberList
 {
-	__block NSArray<IRCChannelUser *> *memberList = nil;
+	__block NSArray<IRCChannelUser *> *memberList = self.memberContainerSnapshot;
+
+	if (memberList) {
+		return memberList;
+	}
+
+	[self accessMemberListUsingBlock:^{
+		NSArray<IRCChannelUser *> *memberListSnapshot = self.memberContainerSnapshot;
+
+		if (memberListSnapshot == nil) {
+			memberListSnapshot = [self.memberContainer copy];
+
+			self.memberContainerSnapshot = memberListSnapshot;
+		}
 
-	[self.class accessMemberListUsingBlock:^{
-		memberList = [self.memberContainer copy];
+		memberList = memberListSnapshot;
 	}];
 
 	return memberList;
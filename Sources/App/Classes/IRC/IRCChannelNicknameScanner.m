@@ -0,0 +1,325 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "NSStringHelper.h"
+#import "IRCChannelUser.h"
+#import "IRCUser.h"
+#import "TLOStringAutomatonPrivate.h"
+#import "IRCChannelNicknameScannerPrivate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/* The scanner is a TLOStringAutomaton built from the case folded
+ nickname of every member. Each string of the automaton is a pattern
+ which maps back to the members that share that nickname. */
+/* A nickname or string whose length changes when it is case folded cannot
+ be mapped back to a range of the string. These are searched for one at
+ a time using -enumerateMatchesOfString: as they were before. */
+/* Patterns which no longer belong to any member stay in the automaton
+ until there are enough of them to warrant rebuilding it. */
+#define _unusedPatternsCompactThreshold		1024
+
+@interface IRCChannelNicknameScannerPattern : NSObject
+@property (nonatomic, strong) NSHashTable<IRCChannelUser *> *members;
+@end
+
+@interface IRCChannelNicknameScanner ()
+@property (nonatomic, strong) TLOStringAutomaton *automaton;
+@property (nonatomic, strong) NSMutableArray<IRCChannelNicknameScannerPattern *> *patterns;
+@property (nonatomic, strong) NSMapTable<IRCChannelUser *, NSNumber *> *memberPatterns;
+@property (nonatomic, strong) NSHashTable<IRCChannelUser *> *unscannableMembers;
+@property (nonatomic, assign) NSUInteger unusedPatternsCount;
+@end
+
+@implementation IRCChannelNicknameScannerPattern
+@end
+
+@implementation IRCChannelNicknameScanner
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		[self prepareInitialState];
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (void)prepareInitialState
+{
+	/* Members are compared by identity because -isEqual: of
+	 IRCChannelUser considers two copies of a member to be equal. */
+	self.memberPatterns = [NSMapTable mapTableWithKeyOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)
+												valueOptions:NSPointerFunctionsStrongMemory];
+
+	self.unscannableMembers = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
+
+	[self createAutomaton];
+}
+
+- (void)createAutomaton
+{
+	self.automaton = [TLOStringAutomaton new];
+
+	self.patterns = [NSMutableArray array];
+
+	self.unusedPatternsCount = 0;
+}
+
+/* Must be called with lock held */
+- (void)compactAutomatonIfNeeded
+{
+	NSUInteger unusedPatternsCount = self.unusedPatternsCount;
+
+	if (unusedPatternsCount < _unusedPatternsCompactThreshold ||
+		unusedPatternsCount < (self.patterns.count - unusedPatternsCount))
+	{
+		return;
+	}
+
+	NSMapTable *memberPatterns = self.memberPatterns;
+
+	NSArray *members = memberPatterns.keyEnumerator.allObjects;
+
+	[memberPatterns removeAllObjects];
+
+	[self createAutomaton];
+
+	for (IRCChannelUser *member in members) {
+		[self _addMember:member];
+	}
+}
+
+#pragma mark -
+#pragma mark Members
+
+- (void)addMember:(IRCChannelUser *)member
+{
+	NSParameterAssert(member != nil);
+
+	@synchronized (self) {
+		[self _addMember:member];
+	}
+}
+
+- (void)addMembers:(NSArray<IRCChannelUser *> *)members
+{
+	NSParameterAssert(members != nil);
+
+	@synchronized (self) {
+		for (IRCChannelUser *member in members) {
+			[self _addMember:member];
+		}
+	}
+}
+
+/* Must be called with lock held */
+- (void)_addMember:(IRCChannelUser *)member
+{
+	if ([self.memberPatterns objectForKey:member] != nil ||
+		[self.unscannableMembers containsObject:member])
+	{
+		return;
+	}
+
+	NSString *nickname = member.user.nickname;
+
+	NSUInteger nicknameLength = nickname.length;
+
+	NSString *foldedNickname = [nickname stringByFoldingWithOptions:NSCaseInsensitiveSearch locale:nil];
+
+	if (nicknameLength == 0 || foldedNickname.length != nicknameLength) {
+		[self.unscannableMembers addObject:member];
+
+		return;
+	}
+
+	NSMutableArray *patterns = self.patterns;
+
+	NSUInteger patternIndex = [self.automaton addString:foldedNickname];
+
+	IRCChannelNicknameScannerPattern *pattern = nil;
+
+	if (patternIndex == patterns.count) {
+		pattern = [IRCChannelNicknameScannerPattern new];
+
+		pattern.members = [NSHashTable hashTableWithOptions:(NSPointerFunctionsStrongMemory | NSPointerFunctionsObjectPointerPersonality)];
+
+		[patterns addObject:pattern];
+	} else {
+		pattern = patterns[patternIndex];
+
+		if (pattern.members.count == 0) {
+			self.unusedPatternsCount -= 1;
+		}
+	}
+
+	[pattern.members addObject:member];
+
+	[self.memberPatterns setObject:@(patternIndex) forKey:member];
+}
+
+- (void)removeMember:(IRCChannelUser *)member
+{
+	NSParameterAssert(member != nil);
+
+	@synchronized (self) {
+		[self.unscannableMembers removeObject:member];
+
+		NSMapTable *memberPatterns = self.memberPatterns;
+
+		/* The pattern is looked up by member instead of by nickname
+		 because the nickname may have changed since it was added. */
+		NSNumber *patternIndex = [memberPatterns objectForKey:member];
+
+		if (patternIndex == nil) {
+			return;
+		}
+
+		[memberPatterns removeObjectForKey:member];
+
+		IRCChannelNicknameScannerPattern *pattern = self.patterns[patternIndex.unsignedIntegerValue];
+
+		[pattern.members removeObject:member];
+
+		if (pattern.members.count == 0) {
+			self.unusedPatternsCount += 1;
+
+			[self compactAutomatonIfNeeded];
+		}
+	}
+}
+
+- (void)removeAllMembers
+{
+	@synchronized (self) {
+		[self.memberPatterns removeAllObjects];
+
+		[self.unscannableMembers removeAllObjects];
+
+		[self createAutomaton];
+	}
+}
+
+#pragma mark -
+#pragma mark Scanning
+
+- (void)enumerateMembersInString:(NSString *)string withBlock:(void (NS_NOESCAPE ^)(IRCChannelUser *member, NSRange range))block
+{
+	NSParameterAssert(string != nil);
+	NSParameterAssert(block != NULL);
+
+	NSUInteger stringLength = string.length;
+
+	if (stringLength == 0) {
+		return;
+	}
+
+	NSString *foldedString = [string stringByFoldingWithOptions:NSCaseInsensitiveSearch locale:nil];
+
+	NSArray<IRCChannelUser *> *unscannableMembers = nil;
+
+	NSMutableArray<NSArray<IRCChannelUser *> *> *matchedMembers = [NSMutableArray array];
+
+	NSMutableArray<NSValue *> *matchedRanges = [NSMutableArray array];
+
+	@synchronized (self) {
+		if (foldedString.length != stringLength) {
+			/* Every member is searched for one at a time */
+			NSMutableArray *allMembers = [self.memberPatterns.keyEnumerator.allObjects mutableCopy];
+
+			[allMembers addObjectsFromArray:self.unscannableMembers.allObjects];
+
+			unscannableMembers = allMembers;
+		} else {
+			unscannableMembers = self.unscannableMembers.allObjects;
+
+			[self scanCharactersOfString:foldedString
+						addingMatchedMembers:matchedMembers
+									  ranges:matchedRanges];
+		}
+	}
+
+	[matchedMembers enumerateObjectsUsingBlock:^(NSArray<IRCChannelUser *> *members, NSUInteger index, BOOL *stop) {
+		NSRange range = matchedRanges[index].rangeValue;
+
+		for (IRCChannelUser *member in members) {
+			block(member, range);
+		}
+	}];
+
+	for (IRCChannelUser *member in unscannableMembers) {
+		NSString *nickname = member.user.nickname;
+
+		if (nickname.length == 0) {
+			continue;
+		}
+
+		[string enumerateMatchesOfString:nickname withBlock:^(NSRange range, BOOL *stop) {
+			block(member, range);
+		} options:NSCaseInsensitiveSearch];
+	}
+}
+
+/* Must be called with lock held */
+- (void)scanCharactersOfString:(NSString *)string addingMatchedMembers:(NSMutableArray<NSArray<IRCChannelUser *> *> *)matchedMembers ranges:(NSMutableArray<NSValue *> *)matchedRanges
+{
+	NSArray<IRCChannelNicknameScannerPattern *> *patterns = self.patterns;
+
+	if (patterns.count == 0) {
+		return; // Nothing to find
+	}
+
+	[self.automaton enumerateMatchesInString:string withBlock:^(NSUInteger patternIndex, NSRange range) {
+		IRCChannelNicknameScannerPattern *pattern = patterns[patternIndex];
+
+		if (pattern.members.count == 0) {
+			return;
+		}
+
+		[matchedMembers addObject:pattern.members.allObjects];
+
+		[matchedRanges addObject:[NSValue valueWithRange:range]];
+	}];
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -79,6 +79,7 @@
 */
 
 #import <objc/message.h>
+#import <stdatomic.h>
 
 #import "NSObjectHelperPrivate.h"
 #import "NSStringHelper.h"
@@ -103,6 +104,7 @@
 #import "TLOSpeechSynthesizerPrivate.h"
 #import "TLOSpokenNotificationPrivate.h"
 #import "TLOTimer.h"
+#import "TLOTimerWheel.h"
 #import "TXGlobalModelsPrivate.h"
 #import "TXMasterControllerPrivate.h"
 #import "TXMenuControllerPrivate.h"
@@ -112,6 +114,7 @@
 #import "TVCLogControllerInlineMediaServicePrivate.h"
 #import "TVCLogControllerOperationQueuePrivate.h"
 #import "TVCLogRenderer.h"
+#import "TVCLogRendererKeywordMatcherPrivate.h"
 #import "TVCLogViewPrivate.h"
 #import "TVCMainWindowPrivate.h"
 #import "TVCMainWindowTextViewPrivate.h"
@@ -143,7 +146,9 @@
 #import "IRCISupportInfoPrivate.h"
 #import "IRCMessagePrivate.h"
 #import "IRCMessageBatchPrivate.h"
+#import "IRCPrefixCachePrivate.h"
 #import "IRCModeInfo.h"
+#import "IRCNetsplitPrivate.h"
 #import "IRCNumerics.h"
 #import "IRCSendingMessage.h"
 #import "IRCServerPrivate.h"
@@ -167,6 +172,13 @@ NS_ASSUME_NONNULL_BEGIN
 #define _timeoutInterval			360
 #define _whoCheckInterval			120
 
+/* Token sent with WHOX requests so that the replies to
+ them can be told apart from those the user asked for */
+#define _whoxPollingQueryToken		@"274"
+
+/* Once full, the oldest highlight is replaced by each new one */
+#define _maximumCachedHighlights	1000
+
 NSString * const IRCClientConfigurationWasUpdatedNotification = @"IRCClientConfigurationWasUpdatedNotification";
 
 NSString * const IRCClientChannelListWasModifiedNotification = @"IRCClientChannelListWasModifiedNotification";
@@ -180,6 +192,16 @@ NSString * const IRCClientDidDisconnectNotification = @"IRCClientDidDisconnectNo
 
 NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNicknameChangedNotification";
 
+/* Time spent in each step of the receive pipeline while /replay is running */
+@interface IRCClientTrafficReplayTimings : NSObject
+@property (nonatomic, assign) CFAbsoluteTime parseTime;
+@property (nonatomic, assign) CFAbsoluteTime interceptTime;
+@property (nonatomic, assign) CFAbsoluteTime memberListTime;
+@property (nonatomic, assign) CFAbsoluteTime dispatchTime;
+@property (nonatomic, assign) CFAbsoluteTime renderTime;
+@property (nonatomic, strong) NSMutableArray<NSString *> *messageBodies;
+@end
+
 @interface IRCClient ()
 // Properties that are public in IRCClient.h
 @property (nonatomic, copy, readwrite) IRCClientConfig *config;
@@ -203,7 +225,8 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 @property (nonatomic, assign, readwrite) NSTimeInterval lastMessageReceived;
 @property (nonatomic, assign, readwrite) NSTimeInterval lastMessageServerTime;
 @property (nonatomic, assign, readwrite) ClientIRCv3SupportedCapability capabilities;
-@property (nonatomic, copy, readwrite) NSArray<IRCHighlightLogEntry *> *cachedHighlights;
+@property (nonatomic, strong) NSMutableArray<IRCHighlightLogEntry *> *cachedHighlightsPrivate;
+@property (nonatomic, assign) NSUInteger cachedHighlightsOldestIndex;
 @property (nonatomic, copy, readwrite, nullable) NSString *userHostmask;
 @property (nonatomic, copy, readwrite) NSString *userNickname;
 @property (nonatomic, copy, readwrite) NSString *serverAddress;
@@ -242,13 +265,24 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 @property (nonatomic, assign) NSUInteger autojoinDelayedWarningCount;
 @property (nonatomic, copy, nullable) NSString *tryingNicknameSentNickname;
 @property (nonatomic, strong) NSMutableArray<IRCChannel *> *channelListPrivate;
+@property (nonatomic, strong) NSMutableOrderedSet<IRCChannel *> *channelStateRefreshTreeItems;
+@property (nonatomic, strong) NSMutableOrderedSet<IRCChannel *> *channelStateRefreshMessageCounts;
+@property (nonatomic, assign) BOOL channelStateRefreshDockIcon;
+@property (nonatomic, assign) BOOL channelStateRefreshScheduled;
 @property (nonatomic, strong, nullable) NSMutableArray<IRCChannel *> *channelsToAutojoin;
 @property (nonatomic, strong) IRCAddressBookMatchCache *addressBookMatchCache;
+@property (nonatomic, strong, readwrite) IRCPrefixCache *prefixCache;
+@property (nonatomic, strong, readwrite) TLOTimerWheel *timerWheel;
 @property (nonatomic, strong) IRCAddressBookUserTrackingContainer *trackedUsers;
 @property (nonatomic, strong) IRCClientRequestedCommands *requestedCommands;
 @property (nonatomic, strong) NSMutableDictionary<NSString *, IRCTimedCommand *> *timedCommands;
-@property (nonatomic, strong) NSMutableDictionary<NSString *, IRCUser *> *userListPrivate;
+@property (strong) NSMutableDictionary<NSString *, IRCUser *> *userListPrivate;
+@property (nonatomic, assign) IRCISupportInfoCaseMapping userListCaseMapping;
+@property (nonatomic, strong) id userListLock; // Guards the above; never replaced
 @property (nonatomic, strong, nullable) NSMutableString *zncBouncerCertificateChainDataMutable;
+@property (nonatomic, strong, nullable) IRCNetsplit *netsplitPending;
+@property (nonatomic, strong, nullable) NSMutableDictionary<NSString *, NSString *> *netsplitUsers;
+@property (nonatomic, strong, nullable) NSMutableDictionary<NSString *, NSMutableArray<NSArray<NSString *> *> *> *whoxPollingReplies;
 @property (nonatomic, copy, nullable) NSString *temporaryServerAddressOverride;
 @property (nonatomic, assign) uint16_t temporaryServerPortOverride;
 @property (readonly) BOOL isBrokenIRCd_aka_Twitch;
@@ -258,6 +292,7 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 @property (readonly, copy) NSArray<NSString *> *nickServSupportedSuccessfulIdentificationTokens;
 @property (nonatomic, strong, nullable) IRCChannel *rawDataLogQuery;
 @property (nonatomic, strong, nullable) IRCChannel *hiddenCommandResponsesQuery;
+@property (strong, nullable) IRCClientTrafficReplayTimings *trafficReplayTimings; // Set while /replay is running
 @end
 
 @implementation IRCClient
@@ -307,17 +342,26 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	self.connectType = IRCClientConnectModeNormal;
 	self.disconnectType = IRCClientDisconnectModeNormal;
 
-	self.cachedHighlights = @[];
+	self.cachedHighlightsPrivate = [NSMutableArray array];
 
 	self.capabilitiesPending = [NSMutableArray array];
 
 	self.channelListPrivate = [NSMutableArray array];
 
+	self.channelStateRefreshTreeItems = [NSMutableOrderedSet orderedSet];
+	self.channelStateRefreshMessageCounts = [NSMutableOrderedSet orderedSet];
+
 	self.timedCommands = [NSMutableDictionary dictionary];
 
-	self.userListPrivate = [NSMutableDictionary dictionary];
+	self.userListLock = [NSObject new];
+
+	self.userListCaseMapping = self.supportInfo.caseMapping;
+
+	self.userListPrivate = IRCISupportInfoCreateCaseMappedDictionary(self.userListCaseMapping);
 
 	self.addressBookMatchCache = [[IRCAddressBookMatchCache alloc] initWithClient:self];
+
+	self.prefixCache = [[IRCPrefixCache alloc] initWithClient:self];
 	
 	self.trackedUsers = [[IRCAddressBookUserTrackingContainer alloc] initWithClient:self];
 
@@ -327,6 +371,11 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 	self.lastServerSelected = NSNotFound;
 
+	/* The timers of the client, timed commands, and the timers that remove
+	 users who no longer share a channel with us are all kept by one wheel.
+	 Intervals shorter than one tick are given a timer of their own. */
+	self.timerWheel = [TLOTimerWheel new];
+
 	self.autojoinTimer =
 	[TLOTimer timerWithActionBlock:^(TLOTimer *sender) {
 		[self onAutojoinTimer];
@@ -367,6 +416,15 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		[self onWhoTimer];
 	}];
 
+	self.autojoinTimer.timerWheel = self.timerWheel;
+	self.autojoinNextJoinTimer.timerWheel = self.timerWheel;
+	self.autojoinDelayedWarningTimer.timerWheel = self.timerWheel;
+	self.isonTimer.timerWheel = self.timerWheel;
+	self.reconnectTimer.timerWheel = self.timerWheel;
+	self.retryTimer.timerWheel = self.timerWheel;
+	self.pongTimer.timerWheel = self.timerWheel;
+	self.whoTimer.timerWheel = self.timerWheel;
+
 	[RZNotificationCenter() addObserver:self selector:@selector(willDestroyChannel:) name:IRCWorldWillDestroyChannelNotification object:nil];
 }
 
@@ -392,9 +450,14 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	self.retryTimer = nil;
 	self.whoTimer = nil;
 
+	[self.timerWheel invalidate];
+
+	self.timerWheel = nil;
+
 	self.addressBookMatchCache = nil;
 	self.batchMessages = nil;
-	self.cachedHighlights = nil;
+	self.prefixCache = nil;
+	self.cachedHighlightsPrivate = nil;
 	self.channelListPrivate = nil;
 	self.channelsToAutojoin = nil;
 	self.logFile = nil;
@@ -1108,9 +1171,35 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 #pragma mark -
 #pragma mark Highlights
 
+- (NSArray<IRCHighlightLogEntry *> *)cachedHighlights
+{
+	NSMutableArray<IRCHighlightLogEntry *> *cachedHighlights = nil;
+
+	@synchronized (self.cachedHighlightsPrivate) {
+		NSArray *highlights = self.cachedHighlightsPrivate;
+
+		NSUInteger highlightsCount = highlights.count;
+
+		cachedHighlights = [NSMutableArray arrayWithCapacity:highlightsCount];
+
+		/* Newest first, walking backwards from the one before the oldest */
+		NSUInteger oldestIndex = self.cachedHighlightsOldestIndex;
+
+		for (NSUInteger i = 1; i <= highlightsCount; i++) {
+			[cachedHighlights addObject:highlights[((oldestIndex + highlightsCount - i) % highlightsCount)]];
+		}
+	}
+
+	return [cachedHighlights copy];
+}
+
 - (void)clearCachedHighlights
 {
-	self.cachedHighlights = @[];
+	@synchronized (self.cachedHighlightsPrivate) {
+		[self.cachedHighlightsPrivate removeAllObjects];
+
+		self.cachedHighlightsOldestIndex = 0;
+	}
 }
 
 - (void)cacheHighlightInChannel:(IRCChannel *)channel withLogLine:(TVCLogLine *)logLine
@@ -1128,14 +1217,30 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	newEntry.clientId = self.uniqueIdentifier;
 	newEntry.channelId = channel.uniqueIdentifier;
 
-	newEntry.lineLogged = logLine;
+	newEntry.lineNumber = logLine.uniqueIdentifier;
+	newEntry.timeLogged = logLine.receivedAt;
+
+	/* The entry points to the line in the historic log instead of keeping
+	 it, unless the line is never written there because the view is encrypted. */
+	if (channel.viewController.encrypted) {
+		newEntry.lineLogged = logLine;
+	}
 
-	/* We insert at head so that latest is always on top. */
-	NSMutableArray *cachedHighlights = [self.cachedHighlights mutableCopy];
+	IRCHighlightLogEntry *entry = [newEntry copy];
+
+	@synchronized (self.cachedHighlightsPrivate) {
+		NSMutableArray *cachedHighlights = self.cachedHighlightsPrivate;
+
+		if (cachedHighlights.count < _maximumCachedHighlights) {
+			[cachedHighlights addObject:entry];
+		} else {
+			NSUInteger oldestIndex = self.cachedHighlightsOldestIndex;
 
-	[cachedHighlights insertObject:[newEntry copy] atIndex:0];
+			cachedHighlights[oldestIndex] = entry;
 
-	self.cachedHighlights = cachedHighlights;
+			self.cachedHighlightsOldestIndex = ((oldestIndex + 1) % _maximumCachedHighlights);
+		}
+	}
 
 	/* Reload table if the window is open. */
 	TDCServerHighlightListSheet *highlightListSheet = [windowController() windowFromWindowList:@"TDCServerHighlightListSheet"];
@@ -1144,7 +1249,7 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		return;
 	}
 
-	[highlightListSheet addEntry:self.cachedHighlights.firstObject];
+	[highlightListSheet addEntry:entry];
 }
 
 #pragma mark -
@@ -2312,6 +2417,10 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	if ([message.senderNickname isEqualToString:@"irc.znc.in"]) {
 		self.isConnectedToZNC = YES;
 
+		/* Nickname validation is relaxed for ZNC which
+		 changes how cached senders would have been parsed. */
+		[self.prefixCache clearCachedPrefixes];
+
 		LogToConsoleInfo("ZNC detected...");
 	}
 }
@@ -2345,9 +2454,7 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 	channel.nicknameHighlightCount += 1;
 
-	[TVCDockIcon updateDockIcon];
-
-	[mainWindow() reloadTreeItem:channel];
+	[self scheduleChannelStateRefreshForChannel:channel reloadTreeItem:YES refreshMessageCount:NO updateDockIcon:YES];
 }
 
 - (void)setUnreadStateForChannel:(IRCChannel *)channel
@@ -2363,10 +2470,12 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		return;
 	}
 
+	BOOL updateDockIcon = NO;
+
 	if (channel.isChannel == NO || [TPCPreferences displayPublicMessageCountOnDockBadge]) {
 		channel.dockUnreadCount += 1;
 
-		[TVCDockIcon updateDockIcon];
+		updateDockIcon = YES;
 	}
 
 	channel.treeUnreadCount += 1;
@@ -2374,7 +2483,65 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	// The isHighlight flag is not sent for the purpose of incrementing
 	// a count. It's passed so that we can know whether the option to
 	// show badge count should be ignored when performing update.
-	if (isHighlight || channel.config.showTreeBadgeCount) {
+	BOOL refreshMessageCount = (isHighlight || channel.config.showTreeBadgeCount);
+
+	[self scheduleChannelStateRefreshForChannel:channel reloadTreeItem:NO refreshMessageCount:refreshMessageCount updateDockIcon:updateDockIcon];
+}
+
+/* Counts are incremented right away but the dock icon and server list are
+ redrawn once for all changes made during the current pass of the main
+ queue. A batch of played back messages would otherwise redraw them for
+ every message that it contains. */
+- (void)scheduleChannelStateRefreshForChannel:(IRCChannel *)channel reloadTreeItem:(BOOL)reloadTreeItem refreshMessageCount:(BOOL)refreshMessageCount updateDockIcon:(BOOL)updateDockIcon
+{
+	NSParameterAssert(channel != nil);
+
+	if (reloadTreeItem) {
+		[self.channelStateRefreshTreeItems addObject:channel];
+	}
+
+	if (refreshMessageCount) {
+		[self.channelStateRefreshMessageCounts addObject:channel];
+	}
+
+	if (updateDockIcon) {
+		self.channelStateRefreshDockIcon = YES;
+	}
+
+	if (self.channelStateRefreshScheduled) {
+		return;
+	}
+
+	self.channelStateRefreshScheduled = YES;
+
+	XRPerformBlockAsynchronouslyOnMainQueue(^{
+		[self performChannelStateRefresh];
+	});
+}
+
+- (void)performChannelStateRefresh
+{
+	self.channelStateRefreshScheduled = NO;
+
+	if (self.channelStateRefreshDockIcon) {
+		self.channelStateRefreshDockIcon = NO;
+
+		[TVCDockIcon updateDockIcon];
+	}
+
+	NSArray *treeItems = self.channelStateRefreshTreeItems.array;
+
+	[self.channelStateRefreshTreeItems removeAllObjects];
+
+	for (IRCChannel *channel in treeItems) {
+		[mainWindow() reloadTreeItem:channel];
+	}
+
+	NSArray *messageCountItems = self.channelStateRefreshMessageCounts.array;
+
+	[self.channelStateRefreshMessageCounts removeAllObjects];
+
+	for (IRCChannel *channel in messageCountItems) {
 		[mainWindowServerList() refreshMessageCountForItem:channel];
 	}
 }
@@ -2387,16 +2554,15 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	NSParameterAssert(withName != nil);
 	NSParameterAssert(channelList != nil);
 
-	NSUInteger channelIndex =
-	[channelList indexOfObjectWithOptions:NSEnumerationConcurrent
-							  passingTest:^BOOL(IRCChannel *channel, NSUInteger index, BOOL *stop) {
-								  NSString *channelName = channel.name;
-
-								  return [withName isEqualToStringIgnoringCase:channelName];
-							  }];
+	/* Comparing names does not allocate memory which makes
+	 a serial search faster than a concurrent one for the
+	 number of channels a client is usually in. */
+	IRCISupportInfoCaseMapping caseMapping = self.supportInfo.caseMapping;
 
-	if (channelIndex != NSNotFound) {
-		return channelList[channelIndex];
+	for (IRCChannel *channel in channelList) {
+		if (IRCISupportInfoStringsAreEqual(caseMapping, withName, channel.name)) {
+			return channel;
+		}
 	}
 
 	return nil;
@@ -2476,9 +2642,7 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 {
 	NSParameterAssert(nickname != nil);
 
-	nickname = nickname.lowercaseString;
-
-	@synchronized (self.userListPrivate) {
+	@synchronized (self.userListLock) {
 		return self.userListPrivate[nickname];
 	}
 }
@@ -2498,14 +2662,14 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 - (NSUInteger)numberOfUsers
 {
-	@synchronized (self.userListPrivate) {
+	@synchronized (self.userListLock) {
 		return self.userListPrivate.count;
 	}
 }
 
 - (NSArray<IRCUser *> *)userList
 {
-	@synchronized (self.userListPrivate) {
+	@synchronized (self.userListLock) {
 		return self.userListPrivate.allValues;
 	}
 }
@@ -2523,9 +2687,9 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		user = [user copy];
 	}
 
-	NSString *nickname = user.lowercaseNickname;
+	NSString *nickname = user.nickname;
 
-	@synchronized (self.userListPrivate) {
+	@synchronized (self.userListLock) {
 		self.userListPrivate[nickname] = user;
 	}
 
@@ -2568,13 +2732,35 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 {
 	NSParameterAssert(nickname != nil);
 
-	nickname = nickname.lowercaseString;
-
-	@synchronized (self.userListPrivate) {
+	@synchronized (self.userListLock) {
 		[self.userListPrivate removeObjectForKey:nickname];
 	}
 }
 
+- (void)updateUserListCaseMapping
+{
+	/* The user list hashes nicknames using the case mapping of
+	 the server which means it has to be rebuilt when that changes. */
+	/* The lock is the same object for the life of the client which means
+	 a writer waiting on it while the list is replaced writes to the new
+	 list once it gets in, not to the old one which is thrown away. */
+	IRCISupportInfoCaseMapping caseMapping = self.supportInfo.caseMapping;
+
+	@synchronized (self.userListLock) {
+		if (self.userListCaseMapping == caseMapping) {
+			return;
+		}
+
+		self.userListCaseMapping = caseMapping;
+
+		NSMutableDictionary *userListNew = IRCISupportInfoCreateCaseMappedDictionary(caseMapping);
+
+		[userListNew addEntriesFromDictionary:self.userListPrivate];
+
+		self.userListPrivate = userListNew;
+	}
+}
+
 - (void)renameUser:(IRCUser *)user to:(NSString *)toNickname
 {
 	NSParameterAssert(user != nil);
@@ -2668,16 +2854,30 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 #pragma mark Send Raw Data
 
 - (void)sendLine:(NSString *)string
+{
+	[self sendLine:string inBackground:NO];
+}
+
+- (void)sendLine:(NSString *)string inBackground:(BOOL)inBackground
 {
 	NSParameterAssert(string != nil);
 
+	/* Replies to replayed traffic have nowhere to go */
+	if (self.isReplayingTraffic) {
+		return;
+	}
+
 	if (self.isConnected == NO) {
 		[self printDebugInformationToConsole:TXTLS(@"IRC[6rj-2r]")];
 
 		return;
 	}
 
-	[self.socket sendLine:string];
+	if (inBackground) {
+		[self.socket sendLineInBackground:string];
+	} else {
+		[self.socket sendLine:string];
+	}
 
 	worldController().bandwidthOut += string.length;
 
@@ -2685,13 +2885,23 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 }
 
 - (void)send:(NSString *)string arguments:(NSArray<NSString *> *)arguments
+{
+	[self send:string arguments:arguments inBackground:NO];
+}
+
+- (void)sendInBackground:(NSString *)string arguments:(NSArray<NSString *> *)arguments
+{
+	[self send:string arguments:arguments inBackground:YES];
+}
+
+- (void)send:(NSString *)string arguments:(NSArray<NSString *> *)arguments inBackground:(BOOL)inBackground
 {
 	NSParameterAssert(string != nil);
 	NSParameterAssert(arguments != nil);
 
 	NSString *stringToSend = [IRCSendingMessage stringWithCommand:string arguments:arguments];
 
-	[self sendLine:stringToSend];
+	[self sendLine:stringToSend inBackground:inBackground];
 }
 
 - (void)send:(NSString *)string, ...
@@ -4178,6 +4388,18 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 			break;
 		}
+		case IRCLocalCommandReplay: // Command: REPLAY
+		{
+			if (stringIn.length == 0) {
+				[self printInvalidSyntaxMessageForCommand:command];
+
+				break;
+			}
+
+			[self replayIncomingTrafficFromFileAtPath:stringIn.string];
+
+			break;
+		}
 		case IRCLocalCommandSetcolor: // Command: SETCOLOR
 		{
 			if ([TPCPreferences disableNicknameColorHashing]) {
@@ -5061,7 +5283,7 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 {
 	NSParameterAssert(logLine != nil);
 
-	if ([TPCPreferences logToDiskIsEnabled] == NO) {
+	if ([TPCPreferences logToDiskIsEnabled] == NO || self.isReplayingTraffic) {
 		return;
 	}
 
@@ -5649,9 +5871,16 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		[self.capabilitiesPending removeAllObjects];
 	}
 
-	@synchronized (self.userListPrivate) {
+	@synchronized (self.userListLock) {
 		[self.userListPrivate removeAllObjects];
 	}
+
+	self.netsplitPending = nil;
+	self.netsplitUsers = nil;
+
+	self.whoxPollingReplies = nil;
+
+	[self.prefixCache clearCachedPrefixes];
 }
 
 - (void)changeStateOff
@@ -5661,7 +5890,9 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 - (void)changeStateOffWithError:(nullable NSError *)disconnectError
 {
-	if (self.isConnecting == NO && self.isConnected == NO) {
+	/* A replay of traffic builds up the same state as a connection
+	 which means it is torn down the same way once it is done. */
+	if (self.isConnecting == NO && self.isConnected == NO && self.isReplayingTraffic == NO) {
 		return;
 	}
 
@@ -5688,6 +5919,8 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 	[self.supportInfo reset];
 
+	[self updateUserListCaseMapping];
+
 	[self clearAddressBookCache];
 
 	[self clearTrackedUsers];
@@ -5926,21 +6159,105 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 {
 	NSParameterAssert(sender == self.socket);
 
-	if (self.isConnected == NO || self.isTerminating) {
+	[self waitForRenderBudget];
+
+	IRCMessage *message = [self messageForIncomingData:data];
+
+	if (message == nil) {
 		return;
 	}
 
-	if (data.length == 0) {
+	if ([self filterBatchCommandIncomingData:message]) {
 		return;
 	}
 
-	self.lastMessageReceived = [NSDate timeIntervalSince1970];
+	[self processIncomingMessage:message];
+}
+
+/* Lines which arrived close together are delivered in batches by
+ the connection service. Each line is parsed on the connection's
+ queue, away from the main thread, and the parsed messages are then
+ processed on the main thread together rather than one trip each. */
+/* Parsing a line can depend on state changed by processing the lines
+ before it. Messages that change that state end the current group so
+ that they are processed before the next line is parsed.
+ Plugins that intercept server input expect to see each line after
+ the lines before it were processed. When one is loaded, every line
+ is its own group which is how lines were handled one at a time. */
+- (void)ircConnection:(IRCConnection *)sender didReceiveLines:(NSArray<NSString *> *)lines
+{
+	NSParameterAssert(sender == self.socket);
+
+	[self waitForRenderBudget];
+
+	BOOL processEachLine = [sharedPluginManager() supportsFeature:THOPluginItemSupportedFeatureServerInputDataInterception];
+
+	NSMutableArray<IRCMessage *> *messages = [NSMutableArray arrayWithCapacity:lines.count];
+
+	for (NSString *line in lines) {
+		IRCMessage *message = [self messageForIncomingData:line];
+
+		if (message == nil) {
+			continue;
+		}
+
+		if ([self filterBatchCommandIncomingData:message]) {
+			continue;
+		}
+
+		[messages addObject:message];
+
+		if (processEachLine || [self incomingMessageChangesParserState:message]) {
+			[self processIncomingMessages:messages];
+
+			[messages removeAllObjects];
+		}
+	}
+
+	[self processIncomingMessages:messages];
+}
+
+/* Hold off on processing more lines until rendering catches up */
+- (void)waitForRenderBudget
+{
+	IRCClientTrafficReplayTimings *replayTimings = self.trafficReplayTimings;
+
+	CFAbsoluteTime startTime = ((replayTimings) ? CFAbsoluteTimeGetCurrent() : 0);
+
+	[[TXSharedApplication sharedPrintingQueue] waitForRenderBudgetForClient:self];
+
+	if (replayTimings) {
+		replayTimings.renderTime += (CFAbsoluteTimeGetCurrent() - startTime);
+	}
+}
+
+/* Returns the message to process or nil if the line should be ignored. */
+- (nullable IRCMessage *)messageForIncomingData:(NSString *)data
+{
+	NSParameterAssert(data != nil);
+
+	if ((self.isConnected == NO && self.isReplayingTraffic == NO) || self.isTerminating) {
+		return nil;
+	}
+
+	if (data.length == 0) {
+		return nil;
+	}
 
-	worldController().bandwidthIn += data.length;
+	IRCClientTrafficReplayTimings *replayTimings = self.trafficReplayTimings;
 
-	worldController().messagesReceived += 1;
+	/* Replayed traffic is not counted and is not written to the raw data log */
+	if (replayTimings == nil) {
+		self.lastMessageReceived = [NSDate timeIntervalSince1970];
 
-	[self rawDataLogIncomingTraffic:data];
+		worldController().bandwidthIn += data.length;
+
+		worldController().messagesReceived += 1;
+
+		[self rawDataLogIncomingTraffic:data];
+	}
+
+	CFAbsoluteTime stepStartTime = ((replayTimings) ? CFAbsoluteTimeGetCurrent() : 0);
 
 	if ([TPCPreferences removeAllFormatting]) {
 		data = data.stripIRCEffects;
@@ -5948,21 +6265,53 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 	IRCMessage *message = [[IRCMessage alloc] initWithLine:data onClient:self];
 
+	if (replayTimings) {
+		CFAbsoluteTime stepEndTime = CFAbsoluteTimeGetCurrent();
+
+		replayTimings.parseTime += (stepEndTime - stepStartTime);
+
+		stepStartTime = stepEndTime;
+	}
+
 	if (message == nil) {
-		return;
+		return nil;
 	}
 
 	message = [THOPluginDispatcher interceptServerInput:message for:self];
 
-	if (message == nil) {
-		return;
+	if (replayTimings) {
+		replayTimings.interceptTime += (CFAbsoluteTimeGetCurrent() - stepStartTime);
 	}
 
-	if ([self filterBatchCommandIncomingData:message]) {
-		return;
+	return message;
+}
+
+/* -[IRCMessage initWithLine:onClient:] reads enabled capabilities and
+ the server address. Capabilities change with CAP and the server
+ address is learned from RPL_WELCOME. RPL_ISUPPORT is included
+ because it changes how nicknames and modes are interpreted.
+ BATCH is included because opening a batch changes where the lines
+ after it are queued by -filterBatchCommandIncomingData: and closing
+ one processes everything queued in it. */
+- (BOOL)incomingMessageChangesParserState:(IRCMessage *)message
+{
+	NSParameterAssert(message != nil);
+
+	switch (message.commandNumeric) {
+		case RPL_WELCOME:
+		case RPL_ISUPPORT:
+		{
+			return YES;
+		}
+		default:
+		{
+			break;
+		}
 	}
 
-	[self processIncomingMessage:message];
+	IRCRemoteCommand command = message.remoteCommand;
+
+	return (command == IRCRemoteCommandCap || command == IRCRemoteCommandBatch);
 }
 
 - (void)processIncomingMessageAttributes:(IRCMessage *)message
@@ -5998,20 +6347,87 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	NSParameterAssert(message != nil);
 
 	XRPerformBlockSynchronouslyOnMainQueue(^{
-		[self _processIncomingMessage:message];
+		[self processIncomingMessageOnMainQueue:message];
+	});
+}
+
+/* Command handlers run on the main thread. They create and remove
+ channels, change the selection, update the member list views, and
+ present dialogs, all of which AppKit requires on the main thread.
+ Moving them to a serial queue of their own would first require the
+ model objects to stop driving the views directly. Until then, the
+ work done away from the main thread is parsing, and the main thread
+ is entered once for each group instead of once for each line. */
+- (void)processIncomingMessages:(NSArray<IRCMessage *> *)messages
+{
+	NSParameterAssert(messages != nil);
+
+	if (messages.count == 0) {
+		return;
+	}
+
+	XRPerformBlockSynchronouslyOnMainQueue(^{
+		for (IRCMessage *message in messages) {
+			/* A message earlier in the group may have disconnected us */
+			if ((self.isConnected == NO && self.isReplayingTraffic == NO) || self.isTerminating) {
+				break;
+			}
+
+			[self processIncomingMessageOnMainQueue:message];
+		}
 	});
 }
 
+- (void)processIncomingMessageOnMainQueue:(IRCMessage *)message
+{
+	NSParameterAssert(message != nil);
+
+	IRCClientTrafficReplayTimings *replayTimings = self.trafficReplayTimings;
+
+	if (replayTimings == nil) {
+		[self _processIncomingMessage:message];
+
+		return;
+	}
+
+	CFAbsoluteTime startTime = CFAbsoluteTimeGetCurrent();
+
+	[self _processIncomingMessage:message];
+
+	CFAbsoluteTime processTime = (CFAbsoluteTimeGetCurrent() - startTime);
+
+	if ([self incomingMessageChangesMemberList:message]) {
+		replayTimings.memberListTime += processTime;
+	} else {
+		replayTimings.dispatchTime += processTime;
+	}
+
+	IRCRemoteCommand command = message.remoteCommand;
+
+	if (command == IRCRemoteCommandPrivmsg || command == IRCRemoteCommandNotice) {
+		[replayTimings.messageBodies addObject:[message paramAt:1]];
+	}
+}
+
 - (void)_processIncomingMessage:(IRCMessage *)message
 {
 	NSParameterAssert(message != nil);
 
+	/* Anything other than a QUIT or JOIN finishes a netsplit in progress */
+	if (self.netsplitPending) {
+		IRCRemoteCommand command = message.remoteCommand;
+
+		if (command != IRCRemoteCommandQuit && command != IRCRemoteCommandJoin) {
+			[self finishNetsplit];
+		}
+	}
+
 	[self processIncomingMessageAttributes:message];
 
 	if (message.commandNumeric > 0) {
 		[self receiveNumericReply:message];
 	} else {
-		NSUInteger commandNumeric = [IRCCommandIndex indexOfRemoteCommand:message.command];
+		IRCRemoteCommand commandNumeric = message.remoteCommand;
 
 		switch (commandNumeric) {
 			case IRCRemoteCommandNotice: // Command: NOTICE
@@ -6156,65 +6572,533 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		return;
 	}
 
-	IRCChannel *query = [self findChannelOrCreate:@"Server Traffic" isUtility:YES];
+	IRCChannel *query = [self findChannelOrCreate:@"Server Traffic" isUtility:YES];
+
+	self.rawDataLogQuery = query;
+
+	[mainWindow() select:query];
+
+	[self rawDataLog:TXTLS(@"IRC[ik6-dl]")];
+}
+
+- (void)destroyRawDataLogQuery
+{
+	if (self.isTerminating) {
+		return;
+	}
+
+	if (self.rawDataLogQuery == nil) {
+		return;
+	}
+
+	[worldController() destroyChannel:self.rawDataLogQuery];
+}
+
+- (void)rawDataLog:(NSString *)data
+{
+	NSParameterAssert(data != nil);
+
+	if (self.isTerminating) {
+		return;
+	}
+
+	XRPerformBlockSynchronouslyOnMainQueue(^{
+		[self printDebugInformation:data inChannel:self.rawDataLogQuery];
+	});
+}
+
+- (void)rawDataLogOutgoingTraffic:(NSString *)data
+{
+	NSParameterAssert(data != nil);
+
+	if (self.rawDataLogQuery == nil) {
+		return;
+	}
+
+	NSString *dataToLog = [NSString stringWithFormat:@"<< %@", data];
+
+	[self rawDataLog:dataToLog];
+}
+
+- (void)rawDataLogIncomingTraffic:(NSString *)data
+{
+	NSParameterAssert(data != nil);
+
+	if (self.rawDataLogQuery == nil) {
+		return;
+	}
+
+	NSString *dataToLog = [NSString stringWithFormat:@">> %@", data];
+
+	[self rawDataLog:dataToLog];
+}
+
+#pragma mark -
+#pragma mark Traffic Replay
+
+/* Traffic replay feeds a capture of incoming traffic to
+ -ircConnection:didReceiveLines: the same way the connection service
+ delivers it and reports how long each step took. It is used to measure
+ the cost of the receive pipeline without a server. The client must be
+ disconnected and stays that way. While replaying, anything it tries to
+ send is dropped and nothing it prints is written to disk. */
+/* Steps timed, by hooks in the receive pipeline:
+ - Parse: turning a line into an IRCMessage.
+ - Plugin intercept: handing the message to plugins.
+ - Member list: handling messages that change who is in a channel.
+ - Dispatch: handling every other message.
+ - Render: waiting for rendering to catch up before a group of lines
+ is handled, and for printed lines to be rendered once every line
+ was handled. Rendering happens in parallel with the other steps
+ so this is only the time spent waiting on it. */
+/* To show how rendering scales, the replay also reports the most
+ views rendered at once and how many workers were busy rendering
+ on average. A capture spread across more channels should keep
+ more workers busy, up to the number of cores. */
+/* Allocations are counted for the whole process while replaying,
+ including on threads which render, and are reported per line.
+ malloc_logger is the hook used by malloc stack logging. It is set
+ only while replaying and is passed along to any logger set before. */
+typedef void (_TXMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numberOfHotFramesToSkip);
+
+extern _TXMallocLogger *malloc_logger;
+
+#define _mallocLogTypeAllocate		2
+
+/* Set when a replay starts and never cleared because a thread
+ may be inside of _replayMallocLogger() when the replay ends. */
+static _TXMallocLogger *_replayPreviousMallocLogger = NULL;
+
+static _Atomic uint64_t _replayAllocationCount = 0;
+
+static BOOL _replayInProgress = NO;
+
+static void _replayMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numberOfHotFramesToSkip)
+{
+	if ((type & _mallocLogTypeAllocate) == _mallocLogTypeAllocate) {
+		atomic_fetch_add_explicit(&_replayAllocationCount, 1, memory_order_relaxed);
+	}
+
+	_TXMallocLogger *previousMallocLogger = _replayPreviousMallocLogger;
+
+	if (previousMallocLogger) {
+		previousMallocLogger(type, arg1, arg2, arg3, result, (numberOfHotFramesToSkip + 1));
+	}
+}
+
+/* The connection service delivers at most this many lines at once */
+#define _replayReceiveBatchMaximumLines		500
+
+/* Each replay is recorded in a history file so that a change can be
+ compared against earlier runs of the same capture. */
+#define _replayHistoryMaximumEntries		500
+
+/* Once the replay is done, highlight keyword matching is measured on
+ its own against the body of every PRIVMSG and NOTICE replayed. */
+#define _replayKeywordBenchmarkKeywordCount			50
+#define _replayKeywordBenchmarkMinimumWordLength	4
+
+- (void)replayIncomingTrafficFromFileAtPath:(NSString *)path
+{
+	NSParameterAssert(path != nil);
+
+	if (self.isConnecting || self.isConnected || self.isReplayingTraffic) {
+		[self printDebugInformation:TXTLS(@"IRC[0tq-w4]")];
+
+		return;
+	}
+
+	NSString *capturePath = path.stringByExpandingTildeInPath;
+
+	NSString *capture = [NSString stringWithContentsOfFile:capturePath encoding:NSUTF8StringEncoding error:NULL];
+
+	if (capture == nil) {
+		[self printDebugInformation:TXTLS(@"IRC[k2w-5r]", path)];
+
+		return;
+	}
+
+	@synchronized ([IRCClient class]) {
+		if (_replayInProgress) {
+			[self printDebugInformation:TXTLS(@"IRC[p7d-3c]")];
+
+			return;
+		}
+
+		_replayInProgress = YES;
+	}
+
+	NSMutableArray<NSString *> *lines = [NSMutableArray array];
+
+	[capture enumerateLinesUsingBlock:^(NSString *line, BOOL *stop) {
+		NSString *lineIn = [self incomingTrafficInCapturedLine:line];
+
+		if (lineIn.length == 0) {
+			return;
+		}
+
+		[lines addObject:lineIn];
+	}];
+
+	NSUInteger lineCount = lines.count;
+
+	[self printDebugInformation:TXTLS(@"IRC[q0e-n8]", lineCount, path)];
+
+	self.reconnectEnabled = NO;
+
+	self.isReplayingTraffic = YES;
+
+	dispatch_queue_t replayQueue = dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0);
+
+	XRPerformBlockAsynchronouslyOnQueue(replayQueue, ^{
+		IRCClientTrafficReplayTimings *replayTimings = [IRCClientTrafficReplayTimings new];
+
+		replayTimings.messageBodies = [NSMutableArray array];
+
+		TVCLogControllerPrintingOperationQueue *printingQueue = [TXSharedApplication sharedPrintingQueue];
+
+		[printingQueue resetLaneStatistics];
+
+		_replayPreviousMallocLogger = malloc_logger;
+
+		atomic_store(&_replayAllocationCount, 0);
+
+		malloc_logger = _replayMallocLogger;
+
+		self.trafficReplayTimings = replayTimings;
+
+		CFAbsoluteTime replayStartTime = CFAbsoluteTimeGetCurrent();
+
+		for (NSUInteger lineIndex = 0; lineIndex < lineCount; lineIndex += _replayReceiveBatchMaximumLines) {
+			NSRange batchRange = NSMakeRange(lineIndex, MIN(_replayReceiveBatchMaximumLines, (lineCount - lineIndex)));
+
+			if (batchRange.length == 1) {
+				[self ircConnection:self.socket didReceiveData:lines[lineIndex]];
+			} else {
+				[self ircConnection:self.socket didReceiveLines:[lines subarrayWithRange:batchRange]];
+			}
+		}
+
+		CFAbsoluteTime renderStartTime = CFAbsoluteTimeGetCurrent();
+
+		[printingQueue waitUntilLinesAreRenderedForClient:self];
+
+		replayTimings.renderTime += (CFAbsoluteTimeGetCurrent() - renderStartTime);
+
+		self.trafficReplayTimings = nil;
+
+		CFAbsoluteTime replayTime = (CFAbsoluteTimeGetCurrent() - replayStartTime);
+
+		NSUInteger peakNumberOfViewsRendering = printingQueue.peakNumberOfLanesDraining;
+
+		double averageNumberOfWorkersRendering = (printingQueue.timeSpentDrainingLanes / replayTime);
+
+		NSUInteger processorCount = [NSProcessInfo processInfo].activeProcessorCount;
+
+		malloc_logger = _replayPreviousMallocLogger;
+
+		uint64_t allocationCount = atomic_load(&_replayAllocationCount);
+
+		NSDictionary *keywordBenchmarkResult = [self benchmarkKeywordMatchingInMessageBodies:replayTimings.messageBodies];
+
+		CFAbsoluteTime parseTime = replayTimings.parseTime;
+		CFAbsoluteTime interceptTime = replayTimings.interceptTime;
+		CFAbsoluteTime memberListTime = replayTimings.memberListTime;
+		CFAbsoluteTime dispatchTime = replayTimings.dispatchTime;
+		CFAbsoluteTime renderTime = replayTimings.renderTime;
+
+		XRPerformBlockAsynchronouslyOnMainQueue(^{
+			[self changeStateOff];
+
+			self.isReplayingTraffic = NO;
+
+			@synchronized ([IRCClient class]) {
+				_replayInProgress = NO;
+			}
+
+			if (replayTime <= 0 || lineCount == 0) {
+				return;
+			}
+
+			double linesPerSecond = (lineCount / replayTime);
+
+			double allocationsPerLine = ((double)allocationCount / lineCount);
+
+			[self printDebugInformation:TXTLS(@"IRC[8zt-4j]", lineCount, replayTime, linesPerSecond)];
+
+			[self printDebugInformation:TXTLS(@"IRC[3fv-w6]",
+				parseTime, ((parseTime / replayTime) * 100.0),
+				interceptTime, ((interceptTime / replayTime) * 100.0),
+				memberListTime, ((memberListTime / replayTime) * 100.0),
+				dispatchTime, ((dispatchTime / replayTime) * 100.0),
+				renderTime, ((renderTime / replayTime) * 100.0))];
+
+			[self printDebugInformation:TXTLS(@"IRC[d6m-2v]", allocationsPerLine)];
+
+			[self printDebugInformation:TXTLS(@"IRC[r3x-8q]", peakNumberOfViewsRendering, averageNumberOfWorkersRendering, processorCount)];
+
+			if (keywordBenchmarkResult) {
+				[self printDebugInformation:TXTLS(@"IRC[w5h-6k]",
+					[keywordBenchmarkResult[@"keywordCount"] unsignedIntegerValue],
+					[keywordBenchmarkResult[@"messageCount"] unsignedIntegerValue],
+					([keywordBenchmarkResult[@"timePerMessage"] doubleValue] * 1000000.0),
+					[keywordBenchmarkResult[@"matchCount"] unsignedIntegerValue])];
+			}
+
+			NSDictionary *result = @{
+				@"date" : @([NSDate date].timeIntervalSince1970),
+				@"capture" : capturePath,
+				@"applicationVersion" : [TPCApplicationInfo applicationVersion],
+				@"lineCount" : @(lineCount),
+				@"totalTime" : @(replayTime),
+				@"linesPerSecond" : @(linesPerSecond),
+				@"allocationsPerLine" : @(allocationsPerLine),
+				@"parseTime" : @(parseTime),
+				@"interceptTime" : @(interceptTime),
+				@"memberListTime" : @(memberListTime),
+				@"dispatchTime" : @(dispatchTime),
+				@"renderTime" : @(renderTime),
+				@"peakNumberOfViewsRendering" : @(peakNumberOfViewsRendering),
+				@"averageNumberOfWorkersRendering" : @(averageNumberOfWorkersRendering),
+				@"processorCount" : @(processorCount)
+			};
+
+			if (keywordBenchmarkResult) {
+				NSMutableDictionary *resultMutable = [result mutableCopy];
+
+				resultMutable[@"keywordMatching"] = keywordBenchmarkResult;
+
+				result = [resultMutable copy];
+			}
+
+			[self recordTrafficReplayResult:result];
+		});
+	});
+}
+
+/* Keywords are the most common words in the bodies so that
+ some of them are found, which is the case that costs most. */
+- (nullable NSDictionary<NSString *, id> *)benchmarkKeywordMatchingInMessageBodies:(NSArray<NSString *> *)messageBodies
+{
+	NSParameterAssert(messageBodies != nil);
+
+	if (messageBodies.count == 0) {
+		return nil;
+	}
+
+	NSCharacterSet *wordSeparators = [NSCharacterSet alphanumericCharacterSet].invertedSet;
+
+	NSCountedSet<NSString *> *words = [NSCountedSet set];
+
+	for (NSString *messageBody in messageBodies) {
+		for (NSString *word in [messageBody.lowercaseString componentsSeparatedByCharactersInSet:wordSeparators]) {
+			if (word.length < _replayKeywordBenchmarkMinimumWordLength) {
+				continue;
+			}
+
+			[words addObject:word];
+		}
+	}
+
+	NSArray<NSString *> *wordsSorted =
+	[words.allObjects sortedArrayUsingComparator:^NSComparisonResult(NSString *word1, NSString *word2) {
+		NSUInteger word1Count = [words countForObject:word1];
+		NSUInteger word2Count = [words countForObject:word2];
+
+		if (word1Count > word2Count) {
+			return NSOrderedAscending;
+		} else if (word1Count < word2Count) {
+			return NSOrderedDescending;
+		}
+
+		return [word1 compare:word2];
+	}];
+
+	if (wordsSorted.count == 0) {
+		return nil;
+	}
+
+	NSArray<NSString *> *keywords = [wordsSorted subarrayWithRange:NSMakeRange(0, MIN(wordsSorted.count, _replayKeywordBenchmarkKeywordCount))];
+
+	TVCLogRendererKeywordMatcher *matcher =
+	[TVCLogRendererKeywordMatcher matcherForHighlightKeywords:keywords
+											 excludedKeywords:nil
+											   matchingMethod:TXNicknameHighlightMatchTypePartial];
+
+	__block NSUInteger matchCount = 0;
+
+	CFAbsoluteTime matchingStartTime = CFAbsoluteTimeGetCurrent();
+
+	for (NSString *messageBody in messageBodies) {
+		[matcher enumerateKeywordsInString:messageBody withBlock:^BOOL(NSRange range) {
+			matchCount += 1;
+
+			return NO;
+		}];
+	}
+
+	CFAbsoluteTime matchingTime = (CFAbsoluteTimeGetCurrent() - matchingStartTime);
+
+	return @{
+		@"keywordCount" : @(keywords.count),
+		@"messageCount" : @(messageBodies.count),
+		@"totalTime" : @(matchingTime),
+		@"timePerMessage" : @(matchingTime / messageBodies.count),
+		@"matchCount" : @(matchCount)
+	};
+}
+
+/* Messages whose handlers mostly update the member list of a channel */
+- (BOOL)incomingMessageChangesMemberList:(IRCMessage *)message
+{
+	NSParameterAssert(message != nil);
+
+	switch (message.commandNumeric) {
+		case RPL_WHOREPLY:
+		case RPL_NAMEREPLY:
+		case RPL_WHOSPCRPL:
+		case RPL_ENDOFNAMES:
+		{
+			return YES;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	switch (message.remoteCommand) {
+		case IRCRemoteCommandJoin:
+		case IRCRemoteCommandKick:
+		case IRCRemoteCommandMode:
+		case IRCRemoteCommandNick:
+		case IRCRemoteCommandPart:
+		case IRCRemoteCommandQuit:
+		{
+			return YES;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	return NO;
+}
+
+- (nullable NSString *)trafficReplayHistoryPath
+{
+	NSString *applicationSupport = [TPCPathInfo applicationSupport];
+
+	if (applicationSupport == nil) {
+		return nil;
+	}
+
+	return [applicationSupport stringByAppendingPathComponent:@"Traffic Replay History.json"];
+}
+
+/* Appends the result to the history and prints how it compares to
+ the previous replay of the same capture, if there is one. */
+- (void)recordTrafficReplayResult:(NSDictionary<NSString *, id> *)result
+{
+	NSParameterAssert(result != nil);
+
+	NSString *historyPath = [self trafficReplayHistoryPath];
+
+	if (historyPath == nil) {
+		return;
+	}
+
+	NSMutableArray *history = nil;
+
+	NSData *historyData = [NSData dataWithContentsOfFile:historyPath];
+
+	if (historyData) {
+		id historyObject = [NSJSONSerialization JSONObjectWithData:historyData options:NSJSONReadingMutableContainers error:NULL];
+
+		if ([historyObject isKindOfClass:[NSMutableArray class]]) {
+			history = historyObject;
+		}
+	}
+
+	if (history == nil) {
+		history = [NSMutableArray array];
+	}
+
+	NSString *capturePath = result[@"capture"];
+
+	for (NSDictionary *previousResult in history.reverseObjectEnumerator) {
+		if ([previousResult isKindOfClass:[NSDictionary class]] == NO ||
+			[previousResult[@"capture"] isEqual:capturePath] == NO)
+		{
+			continue;
+		}
+
+		double previousLinesPerSecond = [previousResult[@"linesPerSecond"] doubleValue];
+		double previousAllocationsPerLine = [previousResult[@"allocationsPerLine"] doubleValue];
+
+		if (previousLinesPerSecond <= 0 || previousAllocationsPerLine <= 0) {
+			break;
+		}
+
+		double linesPerSecondChange = ((([result[@"linesPerSecond"] doubleValue] / previousLinesPerSecond) - 1.0) * 100.0);
+		double allocationsPerLineChange = ((([result[@"allocationsPerLine"] doubleValue] / previousAllocationsPerLine) - 1.0) * 100.0);
 
-	self.rawDataLogQuery = query;
+		NSDate *previousDate = [NSDate dateWithTimeIntervalSince1970:[previousResult[@"date"] doubleValue]];
 
-	[mainWindow() select:query];
+		NSString *previousDateString = TXFormattedTimestamp(previousDate, @"%Y-%m-%d %H:%M:%S");
 
-	[self rawDataLog:TXTLS(@"IRC[ik6-dl]")];
-}
+		[self printDebugInformation:TXTLS(@"IRC[u4k-9f]", previousDateString, linesPerSecondChange, allocationsPerLineChange)];
 
-- (void)destroyRawDataLogQuery
-{
-	if (self.isTerminating) {
-		return;
+		break;
 	}
 
-	if (self.rawDataLogQuery == nil) {
-		return;
+	[history addObject:result];
+
+	if (history.count > _replayHistoryMaximumEntries) {
+		[history removeObjectsInRange:NSMakeRange(0, (history.count - _replayHistoryMaximumEntries))];
 	}
 
-	[worldController() destroyChannel:self.rawDataLogQuery];
-}
+	NSData *historyDataOut = [NSJSONSerialization dataWithJSONObject:history options:NSJSONWritingPrettyPrinted error:NULL];
 
-- (void)rawDataLog:(NSString *)data
-{
-	NSParameterAssert(data != nil);
+	if (historyDataOut == nil || [historyDataOut writeToFile:historyPath atomically:YES] == NO) {
+		LogToConsoleError("Failed to write traffic replay history to '%@'", historyPath);
 
-	if (self.isTerminating) {
 		return;
 	}
 
-	XRPerformBlockSynchronouslyOnMainQueue(^{
-		[self printDebugInformation:data inChannel:self.rawDataLogQuery];
-	});
+	[self printDebugInformation:TXTLS(@"IRC[a1s-7n]", historyPath)];
 }
 
-- (void)rawDataLogOutgoingTraffic:(NSString *)data
+/* A capture is either a copy of the raw data log, in which case incoming
+ lines start with ">> " (possibly after a timestamp), or plain lines. */
+- (nullable NSString *)incomingTrafficInCapturedLine:(NSString *)line
 {
-	NSParameterAssert(data != nil);
+	NSParameterAssert(line != nil);
 
-	if (self.rawDataLogQuery == nil) {
-		return;
-	}
-
-	NSString *dataToLog = [NSString stringWithFormat:@"<< %@", data];
+	NSString *lineIn = line;
 
-	[self rawDataLog:dataToLog];
-}
+	if ([lineIn hasPrefix:@"["]) {
+		NSRange timestampEndRange = [lineIn rangeOfString:@"] "];
 
-- (void)rawDataLogIncomingTraffic:(NSString *)data
-{
-	NSParameterAssert(data != nil);
+		if (timestampEndRange.location != NSNotFound) {
+			NSString *lineWithoutTimestamp = [lineIn substringFromIndex:NSMaxRange(timestampEndRange)];
 
-	if (self.rawDataLogQuery == nil) {
-		return;
+			if ([lineWithoutTimestamp hasPrefix:@">> "] ||
+				[lineWithoutTimestamp hasPrefix:@"<< "])
+			{
+				lineIn = lineWithoutTimestamp;
+			}
+		}
 	}
 
-	NSString *dataToLog = [NSString stringWithFormat:@">> %@", data];
+	if ([lineIn hasPrefix:@"<< "]) {
+		return nil;
+	} else if ([lineIn hasPrefix:@">> "]) {
+		return [lineIn substringFromIndex:3];
+	}
 
-	[self rawDataLog:dataToLog];
+	return lineIn;
 }
 
 #pragma mark -
@@ -7189,6 +8073,12 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		}
 	}
 
+	IRCNetsplit *netjoin = nil;
+
+	if (isPrintOnlyMessage == NO && myself == NO) {
+		netjoin = [self netsplitOfType:IRCNetsplitTypeJoin forMessage:m];
+	}
+
 	if (isPrintOnlyMessage == NO) {
 		/* A user might already exist by having a private message open */
 		IRCUserMutable *userMutable = [self mutableCopyOfUserWithNickname:sender];
@@ -7201,7 +8091,13 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 		IRCChannelUser *member = [[IRCChannelUser alloc] initWithUser:userAdded];
 
-		[channel addMember:member checkForDuplicates:YES];
+		if (netjoin) {
+			[channel stageMembers:@[member]];
+
+			[netjoin addMember:member toChannel:channel];
+		} else {
+			[channel addMember:member checkForDuplicates:YES];
+		}
 	}
 
 	if (isPrintOnlyMessage == NO && myself == NO) {
@@ -7244,6 +8140,12 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		}
 	}
 
+	if (printMessage && netjoin) {
+		[netjoin addNicknameToPrint:sender inChannel:channel];
+
+		printMessage = NO;
+	}
+
 	if (printMessage) {
 		NSString *message = TXTLS(@"IRC[ziu-p9]", sender, m.senderUsername, m.senderAddress.stringByAppendingIRCFormattingStop);
 
@@ -7259,7 +8161,9 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		return;
 	}
 
-	[mainWindow() updateTitleFor:channel];
+	if (netjoin == nil) {
+		[mainWindow() updateTitleFor:channel];
+	}
 
 	if (myself) {
 		if (self.config.sendWhoCommandRequestsToChannels && self.isBrokenIRCd_aka_Twitch == NO) {
@@ -7466,6 +8370,12 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		}
 	}
 
+	IRCNetsplit *netsplit = nil;
+
+	if (isPrintOnlyMessage == NO && myself == NO) {
+		netsplit = [self netsplitOfType:IRCNetsplitTypeSplit forMessage:m];
+	}
+
 	IRCAddressBookEntry *ignoreInfo = nil;
 
 	if (myself == NO) {
@@ -7494,7 +8404,11 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 						return;
 					}
 
-					[channel removeMember:member];
+					if (netsplit) {
+						[netsplit addMember:member toChannel:channel];
+					} else {
+						[channel removeMember:member];
+					}
 
 					break;
 				}
@@ -7536,6 +8450,14 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 				}
 			}
 
+			if (netsplit) {
+				if (printMessage) {
+					[netsplit addNicknameToPrint:sender inChannel:channel];
+				}
+
+				return;
+			}
+
 			[mainWindow() updateTitleFor:channel];
 
 			if (printMessage == NO) {
@@ -7572,7 +8494,9 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	}
 
 	if (myself == NO) {
-		[mainWindow() updateTitleFor:self];
+		if (netsplit == nil) {
+			[mainWindow() updateTitleFor:self];
+		}
 
 		[self notifyEvent:TXNotificationTypeUserDisconnected lineType:TVCLogLineTypeQuit target:nil nickname:sender text:comment];
 	}
@@ -8033,10 +8957,28 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		/* Process queued entries for this batch message. */
 		/* The method used for processing queued entries will 
 		 also remove it from queue once completed. */
+		/* Lines printed while processing the batch are held by each
+		 view and printed together once the batch is processed. */
+		NSMutableArray<TVCLogController *> *viewControllers = [NSMutableArray array];
+
+		[viewControllers addObject:self.viewController];
+
+		for (IRCChannel *channel in self.channelList) {
+			[viewControllers addObject:channel.viewController];
+		}
+
+		[viewControllers makeObjectsPerformSelector:@selector(beginPrintTransaction)];
+
 		[self recursivelyProcessBatchMessage:thisBatchMessage];
 
+		[viewControllers makeObjectsPerformSelector:@selector(endPrintTransaction)];
+
 		/* Set vendor specific flags based on BATCH command values */
-		if ([batchType isEqualToString:@"znc.in/playback"]) {
+		if ([batchType isEqualToString:@"netsplit"] ||
+			[batchType isEqualToString:@"netjoin"])
+		{
+			[self finishNetsplit];
+		} else if ([batchType isEqualToString:@"znc.in/playback"]) {
 			self.zncBouncerIsPlayingBackHistory = NO;
 		} else if ([batchType isEqualToString:@"znc.in/tlsinfo"]) {
 			self.zncBouncerIsSendingCertificateInfo = NO;
@@ -8061,6 +9003,10 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		newBatchMessage.batchToken = batchToken;
 		newBatchMessage.batchType = batchType;
 
+		if ([m paramsCount] > 2) {
+			newBatchMessage.batchParameters = [m.params subarrayWithRange:NSMakeRange(2, ([m paramsCount] - 2))];
+		}
+
 		newBatchMessage.parentBatchMessage = parentBatchMessage;
 
 		[self.batchMessages queueEntry:newBatchMessage];
@@ -8154,7 +9100,7 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 	for (id queuedEntry in queuedEntries) {
 		if ([queuedEntry isKindOfClass:[IRCMessage class]]) {
-			[self processIncomingMessage:queuedEntry];
+			[self _processIncomingMessage:queuedEntry];
 		} else if ([queuedEntry isKindOfClass:[IRCMessageBatchMessage class]]) {
 			[self recursivelyProcessBatchMessage:queuedEntry depth:(recursionDepth + 1)];
 		}
@@ -8165,6 +9111,129 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	}
 }
 
+#pragma mark -
+#pragma mark Netsplits
+
+/* Each user lost in a netsplit is sent as a separate QUIT and each
+ user returning as a separate JOIN for every channel they are in.
+ Rather than updating the member list and printing a line for each,
+ they are collected and handled together when the netsplit finishes.
+ That happens when a message arrives that is not part of it, when its
+ batch closes, or shortly after the first user is collected. */
+- (nullable IRCNetsplit *)netsplitOfType:(IRCNetsplitType)type forMessage:(IRCMessage *)message
+{
+	NSParameterAssert(message != nil);
+
+	NSString *servers = nil;
+
+	IRCMessageBatchMessage *batchMessage = message.parentBatchMessage;
+
+	NSString *batchType = ((type == IRCNetsplitTypeSplit) ? @"netsplit" : @"netjoin");
+
+	if ([batchMessage.batchType isEqualToString:batchType] && batchMessage.batchParameters.count == 2) {
+		servers = [batchMessage.batchParameters componentsJoinedByString:@" "];
+	} else if (type == IRCNetsplitTypeSplit) {
+		servers = [IRCNetsplit serversInQuitComment:[message paramAt:0]];
+	} else {
+		servers = self.netsplitUsers[message.senderNickname];
+	}
+
+	IRCNetsplit *netsplit = self.netsplitPending;
+
+	if (netsplit && (servers == nil || netsplit.type != type || [netsplit.servers isEqualToString:servers] == NO)) {
+		[self finishNetsplit];
+
+		netsplit = nil;
+	}
+
+	if (servers == nil) {
+		return nil;
+	}
+
+	if (netsplit == nil) {
+		netsplit = [[IRCNetsplit alloc] initWithType:type servers:servers receivedAt:message.receivedAt];
+
+		self.netsplitPending = netsplit;
+
+		[self performSelectorInCommonModes:@selector(finishNetsplit) withObject:nil afterDelay:1.0];
+	}
+
+	/* Users lost in a netsplit are remembered for a while so
+	 that they can be recognized when the servers rejoin. */
+	if (type == IRCNetsplitTypeSplit) {
+		if (self.netsplitUsers == nil) {
+			self.netsplitUsers = IRCISupportInfoCreateCaseMappedDictionary(self.supportInfo.caseMapping);
+		}
+
+		self.netsplitUsers[message.senderNickname] = servers;
+
+		[self cancelPerformRequestsWithSelector:@selector(clearNetsplitUsers) object:nil];
+
+		[self performSelectorInCommonModes:@selector(clearNetsplitUsers) withObject:nil afterDelay:600.0];
+	}
+
+	return netsplit;
+}
+
+- (void)finishNetsplit
+{
+	IRCNetsplit *netsplit = self.netsplitPending;
+
+	if (netsplit == nil) {
+		return;
+	}
+
+	self.netsplitPending = nil;
+
+	[self cancelPerformRequestsWithSelector:@selector(finishNetsplit) object:nil];
+
+	BOOL isSplit = (netsplit.type == IRCNetsplitTypeSplit);
+
+	for (IRCChannel *channel in netsplit.channels) {
+		if (channel.isActive == NO) {
+			continue;
+		}
+
+		if (isSplit) {
+			[channel removeMembers:[netsplit membersInChannel:channel]];
+		} else {
+			[channel commitStagedMembers];
+		}
+
+		NSArray *nicknames = [netsplit nicknamesToPrintInChannel:channel];
+
+		if (nicknames.count > 0) {
+			NSString *nicknamesJoined = [nicknames componentsJoinedByString:@", "];
+
+			NSString *message = nil;
+
+			if (isSplit) {
+				message = TXTLS(@"IRC[w2s-ht]", netsplit.firstServer, netsplit.secondServer, nicknames.count, nicknamesJoined);
+			} else {
+				message = TXTLS(@"IRC[j8k-d1]", netsplit.firstServer, netsplit.secondServer, nicknames.count, nicknamesJoined);
+			}
+
+			[self print:message
+					 by:nil
+			  inChannel:channel
+				 asType:((isSplit) ? TVCLogLineTypeQuit : TVCLogLineTypeJoin)
+				command:((isSplit) ? @"QUIT" : @"JOIN")
+			 receivedAt:netsplit.receivedAt];
+		}
+
+		[mainWindow() updateTitleFor:channel];
+	}
+
+	if (isSplit) {
+		[mainWindow() updateTitleFor:self];
+	}
+}
+
+- (void)clearNetsplitUsers
+{
+	self.netsplitUsers = nil;
+}
+
 #pragma mark -
 #pragma mark Server Capability
 
@@ -8941,6 +10010,10 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 			[self.supportInfo processConfigurationData:configuration];
 
+			[self.prefixCache clearCachedPrefixes];
+
+			[self updateUserListCaseMapping];
+
 			if (printMessage) {
 				NSString *configurationFormatted = self.supportInfo.stringValueForLastUpdate;
 
@@ -9721,8 +10794,53 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 			break;
 		}
+		case RPL_WHOSPCRPL:
+		{
+			/* Replies to WHOX requests made by the user are printed.
+			 Replies to polling requests are held until RPL_ENDOFWHO. */
+			/* Example incoming data:
+				<nickname> <token> <channel> <nick> <flags>
+
+				Namikaze 274 #textual solprefixer H@
+			*/
+			if ([m paramsCount] != 5 || [[m paramAt:1] isEqualToString:_whoxPollingQueryToken] == NO) {
+				if (self.requestedCommands.visibleWhoRequest && printMessage) {
+					[self printReplyToHiddenCommandResponsesQuery:m];
+				}
+
+				break;
+			}
+
+			NSString *channelName = [m paramAt:2];
+
+			if (self.whoxPollingReplies == nil) {
+				self.whoxPollingReplies = IRCISupportInfoCreateCaseMappedDictionary(self.supportInfo.caseMapping);
+			}
+
+			NSMutableArray *replies = self.whoxPollingReplies[channelName];
+
+			if (replies == nil) {
+				replies = [NSMutableArray array];
+
+				self.whoxPollingReplies[channelName] = replies;
+			}
+
+			[replies addObject:@[[m paramAt:3], [m paramAt:4]]];
+
+			break;
+		}
 		case RPL_ENDOFWHO:
 		{
+			NSString *channelName = [m paramAt:1];
+
+			NSArray *whoxPollingReplies = self.whoxPollingReplies[channelName];
+
+			if (whoxPollingReplies) {
+				[self.whoxPollingReplies removeObjectForKey:channelName];
+
+				[self applyWhoxPollingReplies:whoxPollingReplies toChannelNamed:channelName];
+			}
+
 			BOOL visibleWhoRequest = self.requestedCommands.visibleWhoRequest;
 
 			[self.requestedCommands recordWhoRequestClosed];
@@ -9755,6 +10873,8 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 			NSArray *nicknames = [nicknamesString componentsSeparatedByCharactersInSet:[NSCharacterSet whitespaceCharacterSet]];
 
+			NSMutableArray<IRCChannelUser *> *membersAdded = [NSMutableArray arrayWithCapacity:nicknames.count];
+
 			for (NSString *nickname in nicknames) {
 				if (nickname.length == 0) {
 					continue;
@@ -9825,16 +10945,19 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 					 then we do not continue unless its us. We are added to the
 					 channel when the JOIN is received, but we still need modes. */
 
-					return;
+					continue;
 				}
 
 				/* Create channel user */
 				memberMutable.modes = memberModes;
 
-				/* Add user to channel */
-				[channel addMember:memberMutable checkForDuplicates:YES];
+				[membersAdded addObject:memberMutable];
 			} // for
 
+			/* Members are added to the member list once all
+			 replies have been received. See RPL_ENDOFNAMES */
+			[channel stageMembers:membersAdded];
+
 			break;
 		}
 		case RPL_ENDOFNAMES:
@@ -9857,6 +10980,8 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 			channel.channelNamesReceived = YES;
 
+			[channel commitStagedMembers];
+
 			/* We have to wait until names are processed before populating
 			 defaults for a channel so that we are certain there is actually
 			 only one user, which is us. */
@@ -10772,11 +11897,13 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	}
 }
 
+/* Autojoin can join a large number of channels at once.
+ Those joins are sent behind anything the user sends. */
 - (void)autojoinChannels:(NSArray<IRCChannel *> *)channels
 {
 	NSParameterAssert(channels != nil);
 
-	[self joinChannels:channels];
+	[self joinChannels:channels inBackground:YES];
 }
 
 - (void)performAutoJoin
@@ -11332,6 +12459,10 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		return;
 	}
 
+	if (self.isReplayingTraffic) {
+		return;
+	}
+
 	/* Check if system is sleeping. */
 	if ([XRSystemInformation systemIsSleeping]) {
 		LogToConsole("Refusing to connect because system is sleeping");
@@ -11770,6 +12901,11 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 }
 
 - (void)joinChannels:(NSArray<IRCChannel *> *)channels
+{
+	[self joinChannels:channels inBackground:NO];
+}
+
+- (void)joinChannels:(NSArray<IRCChannel *> *)channels inBackground:(BOOL)inBackground
 {
 	NSParameterAssert(channels != nil);
 
@@ -11821,11 +12957,11 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 	}
 
 	if (joinStringWithoutKey) {
-		[self send:@"JOIN", joinStringWithoutKey, nil];
+		[self send:@"JOIN" arguments:@[joinStringWithoutKey] inBackground:inBackground];
 	}
 
 	if (joinStringWithKey && keyString) {
-		[self send:@"JOIN", joinStringWithKey, keyString, nil];
+		[self send:@"JOIN" arguments:@[joinStringWithKey, keyString] inBackground:inBackground];
 	}
 }
 
@@ -11914,7 +13050,27 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 		[self.requestedCommands recordWhoRequestOpened];
 	}
 
-	[self send:@"WHO", channel, nil];
+	if (hideResponse == NO) {
+		[self send:@"WHO", channel, nil];
+	} else {
+		[self sendInBackground:@"WHO" arguments:@[channel]];
+	}
+}
+
+- (void)sendWhoxPollingRequestToChannel:(IRCChannel *)channel
+{
+	NSParameterAssert(channel != nil);
+
+	if (self.isLoggedIn == NO) {
+		return;
+	}
+
+	[self.requestedCommands recordWhoRequestOpened];
+
+	/* Fields: t = token, c = channel, n = nickname, f = flags */
+	NSString *fields = [NSString stringWithFormat:@"%%tcnf,%@", _whoxPollingQueryToken];
+
+	[self sendInBackground:@"WHO" arguments:@[channel.name, fields]];
 }
 
 - (void)sendWhois:(NSString *)nickname
@@ -12213,7 +13369,11 @@ NSString * const IRCClientUserNicknameChangedNotification = @"IRCClientUserNickn
 
 	NSString *nicknamesString = [nicknames componentsJoinedByString:@" "];
 
-	[self send:@"ISON", nicknamesString, nil];
+	if (hideResponse == NO) {
+		[self send:@"ISON", nicknamesString, nil];
+	} else {
+		[self sendInBackground:@"ISON" arguments:@[nicknamesString]];
+	}
 }
 
 - (void)requestChannelList
@@ -13071,6 +14231,8 @@ present_error:
 
 	NSMutableArray<IRCChannel *> *channelsToQuery = nil;
 
+	NSMutableArray<IRCChannel *> *channelsToPoll = nil;
+
 	for (NSUInteger channelIndex = startingPosition; channelIndex <= endingPosition; channelIndex++) {
 		IRCChannel *channel = channelList[channelIndex];
 
@@ -13109,11 +14271,22 @@ present_error:
 		}
 
 		/* Add channel to list */
-		if (channelsToQuery == nil) {
-			channelsToQuery = [NSMutableArray new];
-		}
+		/* Once the first WHO has filled in everyone's host, all that a
+		 poll looks for is changes in away and IRCop status. WHOX lets us
+		 ask for only that which is a small fraction of a full reply. */
+		if (sentInitialWhoRequest && self.supportInfo.supportsWHOX) {
+			if (channelsToPoll == nil) {
+				channelsToPoll = [NSMutableArray new];
+			}
+
+			[channelsToPoll addObject:channel];
+		} else {
+			if (channelsToQuery == nil) {
+				channelsToQuery = [NSMutableArray new];
+			}
 
-		[channelsToQuery addObject:channel];
+			[channelsToQuery addObject:channel];
+		}
 
 		/* Update total number of members and maybe break loop */
 		totalMemberCount += numberOfMembers;
@@ -13128,19 +14301,86 @@ present_error:
 	self.lastWhoRequestChannelListIndex = (endingPosition + 1);
 
 	/* Send WHO requests */
-	if (channelsToQuery == nil) {
-		return;
-	}
-
 	for (IRCChannel *channel in channelsToQuery) {
 		[self sendWhoToChannel:channel hideResponse:YES];
 	}
 
+	for (IRCChannel *channel in channelsToPoll) {
+		[self sendWhoxPollingRequestToChannel:channel];
+	}
+
 #undef _maximumChannelCountPerWhoBatchRequest
 #undef _maximumSingleChannelSizePerWhoBatchRequest
 #undef _maximumTotalChannelSizePerWhoBatchRequest
 }
 
+/* Replies to a polling request are applied once the request is
+ finished. Most users have not changed since the last poll which
+ means most replies are compared and then dropped. Only the users
+ whose away or IRCop status changed are copied and redrawn. */
+- (void)applyWhoxPollingReplies:(NSArray<NSArray<NSString *> *> *)replies toChannelNamed:(NSString *)channelName
+{
+	NSParameterAssert(replies != nil);
+	NSParameterAssert(channelName != nil);
+
+	IRCChannel *channel = [self findChannel:channelName];
+
+	if (channel == nil || channel.isActive == NO) {
+		return;
+	}
+
+	BOOL monitorAwayStatus = self.monitorAwayStatus;
+
+	BOOL memberListSortFavorsServerStaff = [TPCPreferences memberListSortFavorsServerStaff];
+
+	for (NSArray<NSString *> *reply in replies) {
+		NSString *nickname = reply[0];
+
+		IRCUser *user = [self findUser:nickname];
+
+		if (user == nil) {
+			continue;
+		}
+
+		IRCChannelUser *member = [user userAssociatedWithChannel:channel];
+
+		if (member == nil) {
+			continue;
+		}
+
+		// Field Syntax: <H|G>[*][@|+]
+		NSString *flags = reply[1];
+
+		BOOL isAway = (monitorAwayStatus && [flags hasPrefix:@"G"]);
+
+		BOOL isIRCop = [flags contains:@"*"];
+
+		BOOL awayStatusChanged = (user.isAway != isAway);
+
+		BOOL IRCopStatusChanged = (user.isIRCop != isIRCop);
+
+		if (awayStatusChanged == NO && IRCopStatusChanged == NO) {
+			continue;
+		}
+
+		IRCUserMutable *userMutable = [user mutableCopy];
+
+		userMutable.isAway = isAway;
+		userMutable.isIRCop = isIRCop;
+
+		IRCUser *userAdded = [self addUserAndReturn:userMutable];
+
+		if (IRCopStatusChanged) {
+			[channel replaceMember:member
+						withMember:member
+							resort:YES
+			  replaceInAllChannels:memberListSortFavorsServerStaff];
+		} else {
+			[mainWindow() updateDrawingForUserInUserList:userAdded];
+		}
+	}
+}
+
 - (void)updateUserTrackingStatusForEntry:(IRCAddressBookEntry *)addressBookEntry withMessage:(IRCMessage *)message
 {
 	NSParameterAssert(addressBookEntry != nil);
@@ -13350,4 +14590,9 @@ present_error:
 
 @end
 
+#pragma mark -
+
+@implementation IRCClientTrafficReplayTimings
+@end
+
 NS_ASSUME_NONNULL_END
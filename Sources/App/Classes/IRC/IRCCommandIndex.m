@@ -43,6 +43,124 @@ NS_ASSUME_NONNULL_BEGIN
 
 #define _reservedSlotDictionaryKey			@"Reserved Information"
 
+#pragma mark -
+#pragma mark Remote Command Table
+
+/* Remote commands are resolved using a perfect hash over the uppercase
+ ASCII characters of the command. The hash of each command listed in
+ IRCCommandIndexRemoteData.plist lands in its own slot so a lookup is
+ one hash, one slot, and one compare. */
+/* When a command is added to the property list, it must be added here
+ as well, and the multipliers changed if two commands collide.
+ Debug builds verify this table against the property list at launch. */
+#define _remoteCommandTableSize			128
+#define _remoteCommandMaximumLength		16
+
+typedef struct {
+	const char name[_remoteCommandMaximumLength];
+	NSUInteger length;
+	IRCRemoteCommand command;
+} IRCRemoteCommandTableEntry;
+
+static IRCRemoteCommandTableEntry const IRCRemoteCommandTable[_remoteCommandTableSize] = {
+	[1] = {"WHOWAS", 6, IRCRemoteCommandWhowas},
+	[2] = {"GLOBOPS", 7, IRCRemoteCommandGlobops},
+	[3] = {"ADCHAT", 6, IRCRemoteCommandAdchat},
+	[7] = {"WALLOPS", 7, IRCRemoteCommandWallops},
+	[8] = {"AWAY", 4, IRCRemoteCommandAway},
+	[9] = {"TEMPSHUN", 8, IRCRemoteCommandTempshun},
+	[10] = {"QUIT", 4, IRCRemoteCommandQuit},
+	[13] = {"NACHAT", 6, IRCRemoteCommandNachat},
+	[17] = {"PING", 4, IRCRemoteCommandPing},
+	[20] = {"CERTINFO", 8, IRCRemoteCommandCertinfo},
+	[22] = {"CHGHOST", 7, IRCRemoteCommandChghost},
+	[23] = {"PONG", 4, IRCRemoteCommandPong},
+	[24] = {"KILL", 4, IRCRemoteCommandKill},
+	[36] = {"BATCH", 5, IRCRemoteCommandBatch},
+	[56] = {"TOPIC", 5, IRCRemoteCommandTopic},
+	[57] = {"WATCH", 5, IRCRemoteCommandWatch},
+	[62] = {"AUTHENTICATE", 12, IRCRemoteCommandAuthenticate},
+	[65] = {"PRIVMSG", 7, IRCRemoteCommandPrivmsg},
+	[80] = {"ERROR", 5, IRCRemoteCommandError},
+	[84] = {"USER", 4, IRCRemoteCommandUser},
+	[85] = {"JOIN", 4, IRCRemoteCommandJoin},
+	[87] = {"SHUN", 4, IRCRemoteCommandShun},
+	[88] = {"ISON", 4, IRCRemoteCommandIson},
+	[89] = {"PASS", 4, IRCRemoteCommandPass},
+	[92] = {"MODE", 4, IRCRemoteCommandMode},
+	[96] = {"GLINE", 5, IRCRemoteCommandGline},
+	[100] = {"NAMES", 5, IRCRemoteCommandNames},
+	[106] = {"WHO", 3, IRCRemoteCommandWho},
+	[107] = {"CAP", 3, IRCRemoteCommandCap},
+	[111] = {"MONITOR", 7, IRCRemoteCommandMonitor},
+	[113] = {"INVITE", 6, IRCRemoteCommandInvite},
+	[115] = {"ZLINE", 5, IRCRemoteCommandZline},
+	[116] = {"WHOIS", 5, IRCRemoteCommandWhois},
+	[117] = {"PART", 4, IRCRemoteCommandPart},
+	[119] = {"NOTICE", 6, IRCRemoteCommandNotice},
+	[121] = {"LIST", 4, IRCRemoteCommandList},
+	[122] = {"CHATOPS", 7, IRCRemoteCommandChatops},
+	[123] = {"GZLINE", 6, IRCRemoteCommandGzline},
+	[124] = {"KICK", 4, IRCRemoteCommandKick},
+	[125] = {"LOCOPS", 6, IRCRemoteCommandLocops},
+	[127] = {"NICK", 4, IRCRemoteCommandNick},
+};
+
+NS_INLINE NSUInteger _IRCRemoteCommandHash(const unichar *characters, NSUInteger length)
+{
+	return ((characters[0] + (characters[(length - 1)] * 28) + (length * 13) + characters[1]) & (_remoteCommandTableSize - 1));
+}
+
+IRCRemoteCommand IRCRemoteCommandFromCharacters(const unichar *characters, NSUInteger length)
+{
+	NSCParameterAssert(characters != NULL);
+
+	if (length < 2 || length >= _remoteCommandMaximumLength) {
+		return NSNotFound;
+	}
+
+	IRCRemoteCommandTableEntry const *entry = &IRCRemoteCommandTable[_IRCRemoteCommandHash(characters, length)];
+
+	if (entry->length != length) {
+		return NSNotFound;
+	}
+
+	for (NSUInteger i = 0; i < length; i++) {
+		if (characters[i] != (unichar)entry->name[i]) {
+			return NSNotFound;
+		}
+	}
+
+	return entry->command;
+}
+
+IRCRemoteCommand IRCRemoteCommandFromString(NSString *command)
+{
+	NSCParameterAssert(command != nil);
+
+	NSUInteger length = command.length;
+
+	if (length < 2 || length >= _remoteCommandMaximumLength) {
+		return NSNotFound;
+	}
+
+	unichar characters[_remoteCommandMaximumLength];
+
+	[command getCharacters:characters range:NSMakeRange(0, length)];
+
+	/* Commands that come from IRCMessage are already uppercase.
+	 Others can come from anywhere so fold them just in case. */
+	for (NSUInteger i = 0; i < length; i++) {
+		if (characters[i] >= 'a' && characters[i] <= 'z') {
+			characters[i] -= ('a' - 'A');
+		}
+	}
+
+	return IRCRemoteCommandFromCharacters(characters, length);
+}
+
+#pragma mark -
+
 @implementation IRCCommandIndex
 
 static NSArray * _Nullable _cachedLocalCommandList = nil;
@@ -86,6 +204,14 @@ static NSDictionary *IRCCommandIndexRemoteData = nil;
 	/* Only error checking we need. It either fails or succeeds. */
 	NSParameterAssert(IRCCommandIndexRemoteData != nil);
 	NSParameterAssert(IRCCommandIndexLocalData != nil);
+
+#if defined(DEBUG)
+	/* Verify the remote command table is in sync with the property list */
+	[IRCCommandIndexRemoteData enumerateKeysAndObjectsUsingBlock:^(NSString *indexKey, NSDictionary *indexValue, BOOL *stop) {
+		NSCAssert((IRCRemoteCommandFromString(indexKey) == [indexValue unsignedIntegerForKey:@"indexValue"]),
+			@"Remote command table is out of sync with property list for '%@' (%@)", indexKey, indexValue);
+	}];
+#endif
 }
 
 + (void)invalidateCaches
@@ -128,27 +254,25 @@ static NSDictionary *IRCCommandIndexRemoteData = nil;
 
 + (NSUInteger)indexOfRemoteCommand:(NSString *)command
 {
-	return [self indexOfCommand:command isLocal:NO];
+	NSParameterAssert(command != nil);
+
+	return IRCRemoteCommandFromString(command);
 }
 
 + (NSUInteger)indexOfCommand:(NSString *)command isLocal:(BOOL)isLocalCommand
 {
-	NSDictionary *index = nil;
-	
-	if (isLocalCommand) {
-		index = IRCCommandIndexLocalData[command.lowercaseString];
-	} else {
-		index = IRCCommandIndexRemoteData[command.lowercaseString];
+	if (isLocalCommand == NO) {
+		return IRCRemoteCommandFromString(command);
 	}
+
+	NSDictionary *index = IRCCommandIndexLocalData[command.lowercaseString];
 	
 	if (index == nil) {
 		return NSNotFound;
 	}
 	
-	if (isLocalCommand) {
-		if ([index boolForKey:@"developerModeOnly"] && [TPCPreferences developerModeEnabled] == NO) {
-			return NSNotFound;
-		}
+	if ([index boolForKey:@"developerModeOnly"] && [TPCPreferences developerModeEnabled] == NO) {
+		return NSNotFound;
 	}
 	
 	return [index unsignedIntegerForKey:@"indexValue"];
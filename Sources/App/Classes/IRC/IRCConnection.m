@@ -47,6 +47,7 @@
 #import "TLOLocalization.h"
 #import "TPCPreferencesLocal.h"
 #import "IRCClient.h"
+#import "IRCCommandIndexPrivate.h"
 #import "IRCConnectionConfig.h"
 #import "IRCConnectionErrors.h"
 #import "IRCConnectionPrivate.h"
@@ -413,6 +414,20 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	NSParameterAssert(line != nil);
 
+	[self sendLine:line lane:[self sendQueueLaneForLine:line]];
+}
+
+- (void)sendLineInBackground:(NSString *)line
+{
+	NSParameterAssert(line != nil);
+
+	[self sendLine:line lane:RCMSendQueueLaneBulk];
+}
+
+- (void)sendLine:(NSString *)line lane:(RCMSendQueueLane)lane
+{
+	NSParameterAssert(line != nil);
+
 	line = [line stringByAppendingString:@"\x0d\x0a"];
 
 	NSData *dataToSend = [self convertToCommonEncoding:line];
@@ -423,17 +438,52 @@ NS_ASSUME_NONNULL_BEGIN
 
 	self.isSending = YES;
 
-	/* PONG replies are extremely important. There is no reason they should be
-	 placed in the flood control queue. This writes them directly to the socket
-	 instead of actually waiting for the queue. We only need this check if
-	 we actually have flood control enabled. */
-	if ([line hasPrefix:@"PONG"]) {
-		[[self remoteObjectProxy] sendData:dataToSend bypassQueue:YES];
+	[[self remoteObjectProxy] sendData:dataToSend lane:lane];
+}
 
-		return;
+- (RCMSendQueueLane)sendQueueLaneForLine:(NSString *)line
+{
+	NSParameterAssert(line != nil);
+
+	NSRange commandRange = [line rangeOfString:@" "];
+
+	NSString *command = nil;
+
+	if (commandRange.location == NSNotFound) {
+		command = line;
+	} else {
+		command = [line substringToIndex:commandRange.location];
 	}
 
-	[[self remoteObjectProxy] sendData:dataToSend];
+	/* PONG replies are extremely important. There is no reason they should
+	 wait behind other lines. The control lane is sent before all others
+	 and is not held back by flood control. Only lines whose order relative
+	 to everything else does not matter belong in it. Everything else,
+	 including QUIT, is sent in the order it was given. */
+	/* CAP and AUTHENTICATE are part of registration along with PASS, NICK,
+	 and USER. Until registration is complete, they are sent in the order
+	 they were given so that none of them overtake the others. */
+	switch (IRCRemoteCommandFromString(command)) {
+		case IRCRemoteCommandPong:
+		{
+			return RCMSendQueueLaneControl;
+		}
+		case IRCRemoteCommandCap:
+		case IRCRemoteCommandAuthenticate:
+		{
+			if (self.client.isLoggedIn) {
+				return RCMSendQueueLaneControl;
+			}
+
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	return RCMSendQueueLaneInteractive;
 }
 
 - (void)clearSendQueue
@@ -515,6 +565,28 @@ NS_ASSUME_NONNULL_BEGIN
 	[self.client ircConnection:self didReceiveData:dataString];
 }
 
+- (void)ircConnectionDidReceiveLines:(NSArray<NSData *> *)lines
+{
+	/* IRCClient performs call to main thread later in stack. */
+	NSMutableArray<NSString *> *lineStrings = [NSMutableArray arrayWithCapacity:lines.count];
+
+	for (NSData *line in lines) {
+		NSString *lineString = [self convertFromCommonEncoding:line];
+
+		if (lineString == nil) {
+			continue;
+		}
+
+		[lineStrings addObject:lineString];
+	}
+
+	if (lineStrings.count == 0) {
+		return;
+	}
+
+	[self.client ircConnection:self didReceiveLines:lineStrings];
+}
+
 - (void)ircConnectionRequestInsecureCertificateTrust:(RCMTrustResponse)trustBlock
 {
 	XRPerformBlockSynchronouslyOnMainQueue(^{
@@ -531,7 +603,18 @@ NS_ASSUME_NONNULL_BEGIN
 			return;
 		}
 
-		[self.client ircConnection:self willSendData:dataString];
+		/* The connection service may join several queued lines
+		 into a single write. The client is informed of each line
+		 separately so that each is logged as it was sent. */
+		NSArray *lines = [dataString componentsSeparatedByString:@"\x0d\x0a"];
+
+		for (NSString *line in lines) {
+			if (line.length == 0) {
+				continue;
+			}
+
+			[self.client ircConnection:self willSendData:[line stringByAppendingString:@"\x0d\x0a"]];
+		}
 	});
 }
 
@@ -45,6 +45,7 @@
 #import "TLOLocalization.h"
 #import "TLONotificationControllerPrivate.h"
 #import "TVCLogLinePrivate.h"
+#import "TVCLogControllerHistoricLogFilePrivate.h"
 #import "IRCHighlightLogEntryInternal.h"
 
 NS_ASSUME_NONNULL_BEGIN
@@ -64,11 +65,69 @@ NS_ASSUME_NONNULL_BEGIN
 	return [logLine renderedBodyForTranscriptLogInChannel:channel];
 }
 
-- (NSString *)timeLoggedFormatted
+- (TVCLogLine *)lineLogged
 {
-	TVCLogLine *logLine = self.lineLogged;
+	TVCLogLine *logLine = self->_lineLogged;
+
+	if (logLine) {
+		return logLine;
+	}
+
+	/* Until the line is fetched from the historic log, or when it
+	 no longer exists there, a placeholder stands in for it. */
+	TVCLogLineMutable *placeholderLine = [TVCLogLineMutable new];
+
+	placeholderLine.receivedAt = self.timeLogged;
+
+	placeholderLine.messageBody = TXTLS(@"BasicLanguage[qv6-3d]");
+
+	return [placeholderLine copy];
+}
+
+- (void)fetchLineLoggedIfNeeded
+{
+	if (self->_lineLogged != nil || self->_lineLoggedFetched) {
+		return;
+	}
+
+	IRCChannel *channel = self.channel;
+
+	if (channel == nil) {
+		return;
+	}
+
+	self->_lineLoggedFetched = YES;
+
+	[TVCLogControllerHistoricLogSharedInstance()
+	 fetchEntriesForItem:channel
+	 withUniqueIdentifier:self.lineNumber
+	 beforeFetchLimit:0
+	 afterFetchLimit:0
+	 limitToDate:nil
+	 withCompletionBlock:^(NSArray<TVCLogLine *> *entries) {
+		 TVCLogLine *logLine = entries.firstObject;
+
+		 XRPerformBlockAsynchronouslyOnMainQueue(^{
+			 /* The line may not be written to the historic log yet.
+			  Allow it to be fetched again the next time it is shown. */
+			 if (logLine == nil) {
+				 self->_lineLoggedFetched = NO;
+
+				 return;
+			 }
+
+			 [self willChangeValueForKey:@"renderedMessage"];
+
+			 self->_lineLogged = logLine;
+
+			 [self didChangeValueForKey:@"renderedMessage"];
+		 });
+	 }];
+}
 
-	NSTimeInterval timeInterval = logLine.receivedAt.timeIntervalSinceNow;
+- (NSString *)timeLoggedFormatted
+{
+	NSTimeInterval timeInterval = self.timeLogged.timeIntervalSinceNow;
 
 	NSString *formattedTimeInterval = TXHumanReadableTimeInterval(timeInterval, YES, 0);
 
@@ -97,7 +156,11 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	IRCChannel *channel = self.channel;
 
-	TVCLogLine *logLine = self.lineLogged;
+	TVCLogLine *logLine = self->_lineLogged;
+
+	if (logLine == nil) {
+		return [[NSAttributedString alloc] initWithString:TXTLS(@"BasicLanguage[qv6-3d]")];
+	}
 
 	NSString *nicknameBody = nil;
 
@@ -120,27 +183,14 @@ NS_ASSUME_NONNULL_BEGIN
 									   preferredFontColor:[NSColor controlTextColor]];
 }
 
-- (NSString *)lineNumber
-{
-	TVCLogLine *logLine = self.lineLogged;
-
-	return logLine.uniqueIdentifier;
-}
-
-- (NSDate *)timeLogged
-{
-	TVCLogLine *logLine = self.lineLogged;
-
-	return logLine.receivedAt;
-}
-
 - (void)initializedClassHealthCheck
 {
 	if (self.mutable) {
 		return;
 	}
 
-	NSParameterAssert(self->_lineLogged != nil);
+	NSParameterAssert(self->_timeLogged != nil);
+	NSParameterAssert(self->_lineNumber.length > 0);
 	NSParameterAssert(self->_clientId.length > 0);
 	NSParameterAssert(self->_channelId.length > 0);
 }
@@ -150,6 +200,8 @@ NS_ASSUME_NONNULL_BEGIN
 	IRCHighlightLogEntry *object = (IRCHighlightLogEntry *)newObject;
 
 	object->_lineLogged = self->_lineLogged;
+	object->_timeLogged = self->_timeLogged;
+	object->_lineNumber = self->_lineNumber;
 	object->_clientId = self->_clientId;
 	object->_channelId = self->_channelId;
 }
@@ -166,6 +218,8 @@ NS_ASSUME_NONNULL_BEGIN
 @implementation IRCHighlightLogEntryMutable
 
 @dynamic lineLogged;
+@dynamic timeLogged;
+@dynamic lineNumber;
 @dynamic clientId;
 @dynamic channelId;
 
@@ -188,6 +242,24 @@ NS_ASSUME_NONNULL_BEGIN
 	}
 }
 
+- (void)setTimeLogged:(NSDate *)timeLogged
+{
+	NSParameterAssert(timeLogged != nil);
+
+	if (self->_timeLogged != timeLogged) {
+		self->_timeLogged = [timeLogged copy];
+	}
+}
+
+- (void)setLineNumber:(NSString *)lineNumber
+{
+	NSParameterAssert(lineNumber != nil);
+
+	if (self->_lineNumber != lineNumber) {
+		self->_lineNumber = [lineNumber copy];
+	}
+}
+
 - (void)setClientId:(NSString *)clientId
 {
 	NSParameterAssert(clientId != nil);
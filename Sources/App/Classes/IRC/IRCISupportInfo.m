@@ -58,6 +58,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign, readwrite) NSUInteger maximumNicknameLength;
 @property (nonatomic, assign, readwrite) NSUInteger maximumTopicLength;
 @property (nonatomic, assign, readwrite) NSUInteger maximumModeCount;
+@property (nonatomic, assign, readwrite) IRCISupportInfoCaseMapping caseMapping;
+@property (nonatomic, assign, readwrite) BOOL supportsWHOX;
 @property (nonatomic, copy, readwrite) NSArray<NSString *> *channelNamePrefixes;
 @property (nonatomic, copy, readwrite) NSArray<NSString *> *statusMessageModeSymbols;
 @property (nonatomic, copy, readwrite) NSDictionary<NSString *, NSNumber *> *channelModes;
@@ -108,6 +110,10 @@ NS_ASSUME_NONNULL_BEGIN
 
 	self.channelNamePrefixes = @[@"#"];
 
+	self.caseMapping = IRCISupportInfoCaseMappingRFC1459;
+
+	self.supportsWHOX = NO;
+
 	self.maximumModeCount = TXMaximumNodesPerModeCommand;
 	self.maximumNicknameLength = IRCProtocolDefaultNicknameMaximumLength;
 
@@ -172,6 +178,8 @@ NS_ASSUME_NONNULL_BEGIN
 				if (awayLength > 0) {
 					self.maximumAwayLength = awayLength;
 				}
+			} else if ([segmentKey isEqualToStringIgnoringCase:@"CASEMAPPING"]) {
+				[self parseCaseMapping:segmentValue];
 			} else if ([segmentKey isEqualToStringIgnoringCase:@"CHANMODES"]) {
 				[self parseChannelModes:segmentValue];
 			} else if ([segmentKey isEqualToStringIgnoringCase:@"CHANNELLEN"]) {
@@ -269,6 +277,8 @@ NS_ASSUME_NONNULL_BEGIN
 			}
 		} else if ([segmentKey isEqualToStringIgnoringCase:@"WATCH"]) {
 			[client enableCapability:ClientIRCv3SupportedCapabilityWatchCommand];
+		} else if ([segmentKey isEqualToStringIgnoringCase:@"WHOX"]) {
+			self.supportsWHOX = YES;
 		}
 	} // while()
 
@@ -368,6 +378,21 @@ NS_ASSUME_NONNULL_BEGIN
 	return [modes copy];
 }
 
+- (void)parseCaseMapping:(NSString *)caseMappingString
+{
+	NSParameterAssert(caseMappingString != nil);
+
+	if ([caseMappingString isEqualToStringIgnoringCase:@"rfc1459"]) {
+		self.caseMapping = IRCISupportInfoCaseMappingRFC1459;
+	} else if ([caseMappingString isEqualToStringIgnoringCase:@"strict-rfc1459"]) {
+		self.caseMapping = IRCISupportInfoCaseMappingStrictRFC1459;
+	} else if ([caseMappingString isEqualToStringIgnoringCase:@"ascii"]) {
+		self.caseMapping = IRCISupportInfoCaseMappingASCII;
+	} else {
+		self.caseMapping = IRCISupportInfoCaseMappingUnicode;
+	}
+}
+
 - (void)parseUserModeSymbols:(NSString *)modeString
 {
 	NSParameterAssert(modeString != nil);
@@ -636,4 +661,229 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+#pragma mark -
+#pragma mark Case Mapping
+
+NS_INLINE unichar _IRCISupportInfoFoldCharacter(IRCISupportInfoCaseMapping caseMapping, unichar character)
+{
+	if (character >= 'A' && character <= 'Z') {
+		return (character + ('a' - 'A'));
+	}
+
+	/* [\]^ are 32 places before {|}~ just like the letters are */
+	switch (caseMapping) {
+		case IRCISupportInfoCaseMappingRFC1459:
+		{
+			if (character >= '[' && character <= '^') {
+				return (character + ('{' - '['));
+			}
+
+			break;
+		}
+		case IRCISupportInfoCaseMappingStrictRFC1459:
+		{
+			if (character >= '[' && character <= ']') {
+				return (character + ('{' - '['));
+			}
+
+			break;
+		}
+		default:
+		{
+			break;
+		}
+	}
+
+	return character;
+}
+
+NSUInteger IRCISupportInfoFoldString(IRCISupportInfoCaseMapping caseMapping, NSString *string, unichar *buffer, NSUInteger bufferLength)
+{
+	NSCParameterAssert(string != nil);
+	NSCParameterAssert(buffer != NULL);
+
+	CFIndex stringLength = CFStringGetLength((__bridge CFStringRef)string);
+
+	if ((NSUInteger)stringLength > bufferLength) {
+		return NSNotFound;
+	}
+
+	CFStringGetCharacters((__bridge CFStringRef)string, CFRangeMake(0, stringLength), buffer);
+
+	for (CFIndex i = 0; i < stringLength; i++) {
+		buffer[i] = _IRCISupportInfoFoldCharacter(caseMapping, buffer[i]);
+	}
+
+	return stringLength;
+}
+
+/* The Unicode case mapping is only used by a handful of networks
+ and non-ASCII nicknames are uncommon on those. Strings containing
+ non-ASCII characters fall back to -lowercaseString for that mapping. */
+NS_INLINE BOOL _IRCISupportInfoStringNeedsUnicodeFolding(IRCISupportInfoCaseMapping caseMapping, CFStringRef string, CFIndex stringLength)
+{
+	if (caseMapping != IRCISupportInfoCaseMappingUnicode) {
+		return NO;
+	}
+
+	CFStringInlineBuffer stringBuffer;
+
+	CFStringInitInlineBuffer(string, &stringBuffer, CFRangeMake(0, stringLength));
+
+	for (CFIndex i = 0; i < stringLength; i++) {
+		if (CFStringGetCharacterFromInlineBuffer(&stringBuffer, i) > 0x7f) {
+			return YES;
+		}
+	}
+
+	return NO;
+}
+
+NS_INLINE NSUInteger _IRCISupportInfoHashCharacters(IRCISupportInfoCaseMapping caseMapping, CFStringRef string, CFIndex stringLength)
+{
+	CFStringInlineBuffer stringBuffer;
+
+	CFStringInitInlineBuffer(string, &stringBuffer, CFRangeMake(0, stringLength));
+
+	/* FNV-1a */
+	NSUInteger hash = 2166136261U;
+
+	for (CFIndex i = 0; i < stringLength; i++) {
+		unichar character = CFStringGetCharacterFromInlineBuffer(&stringBuffer, i);
+
+		hash ^= _IRCISupportInfoFoldCharacter(caseMapping, character);
+
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+NSUInteger IRCISupportInfoHashString(IRCISupportInfoCaseMapping caseMapping, NSString *string)
+{
+	NSCParameterAssert(string != nil);
+
+	CFStringRef stringRef = (__bridge CFStringRef)string;
+
+	CFIndex stringLength = CFStringGetLength(stringRef);
+
+	/* Some non-ASCII characters lowercase to ASCII characters which means
+	 the lowercased string has to be hashed the same way as any other. */
+	if (_IRCISupportInfoStringNeedsUnicodeFolding(caseMapping, stringRef, stringLength)) {
+		stringRef = (__bridge CFStringRef)string.lowercaseString;
+
+		stringLength = CFStringGetLength(stringRef);
+	}
+
+	return _IRCISupportInfoHashCharacters(caseMapping, stringRef, stringLength);
+}
+
+BOOL IRCISupportInfoStringsAreEqual(IRCISupportInfoCaseMapping caseMapping, NSString *string1, NSString *string2)
+{
+	NSCParameterAssert(string1 != nil);
+	NSCParameterAssert(string2 != nil);
+
+	if (string1 == string2) {
+		return YES;
+	}
+
+	CFStringRef string1Ref = (__bridge CFStringRef)string1;
+	CFStringRef string2Ref = (__bridge CFStringRef)string2;
+
+	CFIndex string1Length = CFStringGetLength(string1Ref);
+	CFIndex string2Length = CFStringGetLength(string2Ref);
+
+	if (_IRCISupportInfoStringNeedsUnicodeFolding(caseMapping, string1Ref, string1Length) ||
+		_IRCISupportInfoStringNeedsUnicodeFolding(caseMapping, string2Ref, string2Length))
+	{
+		return [string1.lowercaseString isEqualToString:string2.lowercaseString];
+	}
+
+	if (string1Length != string2Length) {
+		return NO;
+	}
+
+	CFStringInlineBuffer string1Buffer;
+	CFStringInlineBuffer string2Buffer;
+
+	CFStringInitInlineBuffer(string1Ref, &string1Buffer, CFRangeMake(0, string1Length));
+	CFStringInitInlineBuffer(string2Ref, &string2Buffer, CFRangeMake(0, string2Length));
+
+	for (CFIndex i = 0; i < string1Length; i++) {
+		unichar character1 = CFStringGetCharacterFromInlineBuffer(&string1Buffer, i);
+		unichar character2 = CFStringGetCharacterFromInlineBuffer(&string2Buffer, i);
+
+		if (character1 == character2) {
+			continue;
+		}
+
+		if (_IRCISupportInfoFoldCharacter(caseMapping, character1) !=
+			_IRCISupportInfoFoldCharacter(caseMapping, character2))
+		{
+			return NO;
+		}
+	}
+
+	return YES;
+}
+
+/* CFDictionary callbacks have no context so there is one pair per case mapping */
+#define _IRCISupportInfoDefineKeyCallbacks(_caseMapping_)	\
+	static Boolean _IRCISupportInfoKeyEqual##_caseMapping_(const void *value1, const void *value2)	\
+	{	\
+		return IRCISupportInfoStringsAreEqual(IRCISupportInfoCaseMapping##_caseMapping_, (__bridge NSString *)value1, (__bridge NSString *)value2);	\
+	}	\
+	static CFHashCode _IRCISupportInfoKeyHash##_caseMapping_(const void *value)	\
+	{	\
+		return IRCISupportInfoHashString(IRCISupportInfoCaseMapping##_caseMapping_, (__bridge NSString *)value);	\
+	}
+
+_IRCISupportInfoDefineKeyCallbacks(RFC1459)
+_IRCISupportInfoDefineKeyCallbacks(StrictRFC1459)
+_IRCISupportInfoDefineKeyCallbacks(ASCII)
+_IRCISupportInfoDefineKeyCallbacks(Unicode)
+
+#undef _IRCISupportInfoDefineKeyCallbacks
+
+NSMutableDictionary *IRCISupportInfoCreateCaseMappedDictionary(IRCISupportInfoCaseMapping caseMapping)
+{
+	CFDictionaryKeyCallBacks keyCallbacks = kCFTypeDictionaryKeyCallBacks;
+
+	switch (caseMapping) {
+		case IRCISupportInfoCaseMappingRFC1459:
+		{
+			keyCallbacks.equal = _IRCISupportInfoKeyEqualRFC1459;
+			keyCallbacks.hash = _IRCISupportInfoKeyHashRFC1459;
+
+			break;
+		}
+		case IRCISupportInfoCaseMappingStrictRFC1459:
+		{
+			keyCallbacks.equal = _IRCISupportInfoKeyEqualStrictRFC1459;
+			keyCallbacks.hash = _IRCISupportInfoKeyHashStrictRFC1459;
+
+			break;
+		}
+		case IRCISupportInfoCaseMappingASCII:
+		{
+			keyCallbacks.equal = _IRCISupportInfoKeyEqualASCII;
+			keyCallbacks.hash = _IRCISupportInfoKeyHashASCII;
+
+			break;
+		}
+		case IRCISupportInfoCaseMappingUnicode:
+		{
+			keyCallbacks.equal = _IRCISupportInfoKeyEqualUnicode;
+			keyCallbacks.hash = _IRCISupportInfoKeyHashUnicode;
+
+			break;
+		}
+	}
+
+	CFMutableDictionaryRef dictionary =
+	CFDictionaryCreateMutable(kCFAllocatorDefault, 0, &keyCallbacks, &kCFTypeDictionaryValueCallBacks);
+
+	return (__bridge_transfer NSMutableDictionary *)dictionary;
+}
+
 NS_ASSUME_NONNULL_END
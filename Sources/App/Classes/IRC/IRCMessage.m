@@ -36,15 +36,56 @@
  *
  *********************************************************************** */
 
+#import <stdatomic.h>
+
 #import "NSObjectHelperPrivate.h"
 #import "NSStringHelper.h"
 #import "TXGlobalModelsPrivate.h"
 #import "IRCClientPrivate.h"
+#import "IRCCommandIndexPrivate.h"
 #import "IRCPrefix.h"
+#import "IRCPrefixCachePrivate.h"
 #import "IRCMessageInternal.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
+/* Values which are parsed the first time they are asked for are published
+ by swapping an atomic pointer that holds a retained reference. Once it is
+ published, reading a value is a single load without a lock. If two threads
+ parse a value at the same time, the first to publish wins and the other
+ thread uses its value instead of its own. */
+static id _Nullable IRCMessageLoadPublishedObject(void * _Nullable _Atomic *pointer)
+{
+	return (__bridge id)atomic_load_explicit(pointer, memory_order_acquire);
+}
+
+static id IRCMessagePublishObject(void * _Nullable _Atomic *pointer, id object)
+{
+	void *objectRetained = (void *)CFBridgingRetain(object);
+
+	void *objectPublished = NULL;
+
+	if (atomic_compare_exchange_strong_explicit(pointer, &objectPublished, objectRetained, memory_order_acq_rel, memory_order_acquire)) {
+		return object;
+	}
+
+	CFRelease(objectRetained);
+
+	return (__bridge id)objectPublished;
+}
+
+/* Used when the object is not shared yet, such as while it is being copied */
+static void IRCMessageReplacePublishedObject(void * _Nullable _Atomic *pointer, id _Nullable object)
+{
+	void *objectRetained = ((object) ? (void *)CFBridgingRetain(object) : NULL);
+
+	void *objectReplaced = atomic_exchange_explicit(pointer, objectRetained, memory_order_acq_rel);
+
+	if (objectReplaced) {
+		CFRelease(objectReplaced);
+	}
+}
+
 @implementation IRCMessage
 
 DESIGNATED_INITIALIZER_EXCEPTION_BODY_BEGIN
@@ -84,13 +125,41 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 
 - (void)populateDefaultsPostflight
 {
-	SetVariableIfNil(self->_command, @"")
+	if (self->_command == nil) {
+		self->_command = @"";
+
+		self->_remoteCommand = NSNotFound;
+	}
+
 	SetVariableIfNil(self->_messageTags, @{})
-	SetVariableIfNil(self->_params, @[])
 	SetVariableIfNil(self->_receivedAt, [NSDate date])
 	SetVariableIfNil(self->_sender, [IRCPrefix new])
 }
 
+- (void)dealloc
+{
+	IRCMessageReplacePublishedObject(&self->_params, nil);
+}
+
+- (NSArray<NSString *> *)params
+{
+	NSArray<NSString *> *params = IRCMessageLoadPublishedObject(&self->_params);
+
+	if (params) {
+		return params;
+	}
+
+	NSString *paramsLine = self->_paramsLine;
+
+	if (paramsLine == nil) {
+		params = @[];
+	} else {
+		params = [self parseParamsInLine:paramsLine fromLocation:self->_paramsLineLocation];
+	}
+
+	return IRCMessagePublishObject(&self->_params, params);
+}
+
 - (NSUInteger)paramsCount
 {
 	return self.params.count;
@@ -98,8 +167,10 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 
 - (NSString *)paramAt:(NSUInteger)index
 {
-	if (index < self.params.count) {
-		return self.params[index];
+	NSArray *params = self.params;
+
+	if (index < params.count) {
+		return params[index];
 	}
 
 	return @"";
@@ -172,11 +243,12 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 	object->_batchToken = self->_batchToken;
 	object->_command = self->_command;
 	object->_commandNumeric = self->_commandNumeric;
+	object->_remoteCommand = self->_remoteCommand;
 	object->_isHistoric = self->_isHistoric;
 	object->_isEventOnlyMessage = self->_isEventOnlyMessage;
 	object->_isPrintOnlyMessage = self->_isPrintOnlyMessage;
 	object->_messageTags = self->_messageTags;
-	object->_params = self->_params;
+	IRCMessageReplacePublishedObject(&object->_params, self.params);
 	object->_receivedAt = self->_receivedAt;
 	object->_sender = self->_sender;
 }
@@ -190,38 +262,143 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 
 #pragma mark -
 
-@implementation IRCMessage (IRCMessageLineParser)
+/* The line parser performs a single pass over the line to locate
+ the spans of each section of the message. Strings are only created
+ for the sections which are needed right away (tags, prefix, and
+ command). The parameters are scanned again and turned into strings
+ the first time they are actually asked for. */
+/* All delimiters in the IRC framing are ASCII which means scanning
+ the UTF-16 storage of the line is equivalent to scanning its bytes. */
+typedef struct {
+	NSRange tags; // Excludes leading @
+	NSRange prefix; // Excludes leading :
+	NSRange command;
+	NSUInteger paramsLocation;
+} IRCMessageLineSpans;
+
+NS_INLINE NSUInteger _IRCMessageScanToken(CFStringInlineBuffer *buffer, NSUInteger location, NSUInteger length, NSRange *tokenRange)
+{
+	NSUInteger tokenEnd = location;
 
-- (BOOL)parseLine:(NSString *)line forClient:(nullable IRCClient *)client
+	while (tokenEnd < length && CFStringGetCharacterFromInlineBuffer(buffer, tokenEnd) != ' ') {
+		tokenEnd++;
+	}
+
+	*tokenRange = NSMakeRange(location, (tokenEnd - location));
+
+	/* Consume all spaces which follow the token */
+	while (tokenEnd < length && CFStringGetCharacterFromInlineBuffer(buffer, tokenEnd) == ' ') {
+		tokenEnd++;
+	}
+
+	return tokenEnd;
+}
+
+static BOOL _IRCMessageScanLine(NSString *line, IRCMessageLineSpans *spans)
 {
-	NSParameterAssert(line != nil);
+	NSUInteger length = line.length;
 
-	NSMutableString *lineMutable = [line mutableCopy];
+	CFStringInlineBuffer buffer;
 
-	/* Parse extension information (if present) */
-	if ([lineMutable hasPrefix:@"@"]) {
-		NSString *extensionInfo = lineMutable.token;
+	CFStringInitInlineBuffer((__bridge CFStringRef)line, &buffer, CFRangeMake(0, length));
+
+	NSUInteger location = 0;
 
-		if (extensionInfo.length <= 1) {
+	spans->tags = NSMakeRange(NSNotFound, 0);
+	spans->prefix = NSMakeRange(NSNotFound, 0);
+
+	/* Extension information (if present) */
+	if (length > 0 && CFStringGetCharacterFromInlineBuffer(&buffer, location) == '@') {
+		NSRange tagsRange;
+
+		location = _IRCMessageScanToken(&buffer, location, length, &tagsRange);
+
+		if (tagsRange.length <= 1) {
 			return NO;
 		}
 
-		extensionInfo = [extensionInfo substringFromIndex:1];
-
-		[self parseExtensions:extensionInfo forClient:client];
+		spans->tags = NSMakeRange((tagsRange.location + 1), (tagsRange.length - 1));
 	}
 
-	/* Parse sender information (if present) */
-	if ([lineMutable hasPrefix:@":"]) {
-		NSString *senderInfo = lineMutable.token;
+	/* Sender information (if present) */
+	if (location < length && CFStringGetCharacterFromInlineBuffer(&buffer, location) == ':') {
+		NSRange prefixRange;
+
+		location = _IRCMessageScanToken(&buffer, location, length, &prefixRange);
 
-		if (senderInfo.length <= 1) {
+		if (prefixRange.length <= 1) {
 			return NO;
 		}
 
-		senderInfo = [senderInfo substringFromIndex:1];
+		spans->prefix = NSMakeRange((prefixRange.location + 1), (prefixRange.length - 1));
+	}
 
-		[self parseSender:senderInfo forClient:client];
+	/* Command */
+	location = _IRCMessageScanToken(&buffer, location, length, &spans->command);
+
+	if (spans->command.length < 1) {
+		return NO;
+	}
+
+	spans->paramsLocation = location;
+
+	return YES;
+}
+
+IRCPrefix *IRCMessageParseSender(NSString *senderInfo, IRCClient * _Nullable client)
+{
+	NSParameterAssert(senderInfo != nil);
+
+	IRCPrefixMutable *sender = [IRCPrefixMutable new];
+
+	NSString *senderNickname = nil;
+	NSString *senderUsername = nil;
+	NSString *senderAddress = nil;
+
+	sender.hostmask = senderInfo;// Declare entire section as host
+
+	/* Parse the user info into their appropriate sections or return NO if we can't. */
+	if ([senderInfo hostmaskComponents:&senderNickname username:&senderUsername address:&senderAddress onClient:client]) {
+		sender.nickname = senderNickname;
+		sender.username = senderUsername;
+		sender.address = senderAddress;
+	} else {
+		sender.nickname = senderInfo;
+
+		sender.isServer = YES;
+	}
+
+	return [sender copy];
+}
+
+@implementation IRCMessage (IRCMessageLineParser)
+
+- (BOOL)parseLine:(NSString *)line forClient:(nullable IRCClient *)client
+{
+	NSParameterAssert(line != nil);
+
+	line = [line copy];
+
+	IRCMessageLineSpans spans;
+
+	if (_IRCMessageScanLine(line, &spans) == NO) {
+		return NO;
+	}
+
+	/* Parse extension information (if present) */
+	if (spans.tags.location != NSNotFound) {
+		[self parseExtensionsInRange:spans.tags ofLine:line forClient:client];
+	}
+
+	/* Parse sender information (if present) */
+	if (spans.prefix.location != NSNotFound) {
+		if (client) {
+			self->_sender = [client.prefixCache prefixInRange:spans.prefix ofLine:line];
+		} else {
+			NSString *senderInfo = [line substringWithRange:spans.prefix];
+
+			[self parseSender:senderInfo forClient:client];
+		}
 	} else {
 		/* If the line does not have a sender, then we use the 
 		 server address as the sender. If that isn't known, then
@@ -244,29 +421,120 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 	}
 
 	/* Parse command */
-	NSString *command = lineMutable.token;
+	[self parseCommandInRange:spans.command ofLine:line];
 
-	if (command.length < 1) {
-		return NO;
+	/* Parameters are deferred until -params is called */
+	self->_paramsLine = line;
+
+	self->_paramsLineLocation = spans.paramsLocation;
+
+	/* Return success */
+	return YES;
+}
+
+- (void)parseCommandInRange:(NSRange)commandRange ofLine:(NSString *)line
+{
+	NSParameterAssert(line != nil);
+
+	/* The longest command or numeric we care about is well
+	 below this limit. Anything longer takes the slow path. */
+	unichar characters[32];
+
+	if (commandRange.length > (sizeof(characters) / sizeof(unichar))) {
+		NSString *command = [line substringWithRange:commandRange];
+
+		if (command.isNumericOnly) {
+			self->_command = command;
+
+			self->_commandNumeric = command.integerValue;
+
+			self->_remoteCommand = NSNotFound;
+		} else {
+			self->_command = command.uppercaseString;
+
+			self->_commandNumeric = 0;
+
+			self->_remoteCommand = IRCRemoteCommandFromString(self->_command);
+		}
+
+		return;
 	}
 
-	if (command.isNumericOnly) {
-		self->_command = [command copy];
+	[line getCharacters:characters range:commandRange];
 
-		self->_commandNumeric = command.integerValue;
-	} else {
-		self->_command = [command.uppercaseString copy];
+	BOOL isNumeric = YES;
+	BOOL isASCII = YES;
+	BOOL isUppercase = YES;
+
+	NSUInteger commandNumeric = 0;
+
+	for (NSUInteger i = 0; i < commandRange.length; i++) {
+		unichar character = characters[i];
+
+		if (character >= '0' && character <= '9') {
+			commandNumeric = ((commandNumeric * 10) + (character - '0'));
+
+			continue;
+		}
 
-		self->_commandNumeric = 0;
+		isNumeric = NO;
+
+		if (character >= 'a' && character <= 'z') {
+			characters[i] = (character - ('a' - 'A'));
+
+			isUppercase = NO;
+		} else if (character > 0x7f) {
+			isASCII = NO;
+		}
 	}
 
-	/* Parse remaining data */
+	if (isNumeric) {
+		self->_command = [line substringWithRange:commandRange];
+
+		self->_commandNumeric = commandNumeric;
+
+		self->_remoteCommand = NSNotFound;
+
+		return;
+	}
+
+	self->_commandNumeric = 0;
+
+	if (isASCII == NO) {
+		self->_command = [line substringWithRange:commandRange].uppercaseString;
+
+		self->_remoteCommand = NSNotFound;
+
+		return;
+	}
+
+	/* The characters are uppercase at this point so the command
+	 can be resolved without creating a string to look it up. */
+	if (isUppercase) {
+		self->_command = [line substringWithRange:commandRange];
+	} else {
+		self->_command = [NSString stringWithCharacters:characters length:commandRange.length];
+	}
+
+	self->_remoteCommand = IRCRemoteCommandFromCharacters(characters, commandRange.length);
+}
+
+- (NSArray<NSString *> *)parseParamsInLine:(NSString *)line fromLocation:(NSUInteger)location
+{
+	NSParameterAssert(line != nil);
+
+	NSUInteger length = line.length;
+
 	NSMutableArray<NSString *> *parameters = [NSMutableArray new];
 
-	while (lineMutable.length > 0) {
-		if ([lineMutable hasPrefix:@":"])
+	CFStringInlineBuffer buffer;
+
+	CFStringInitInlineBuffer((__bridge CFStringRef)line, &buffer, CFRangeMake(0, length));
+
+	while (location < length) {
+		if (CFStringGetCharacterFromInlineBuffer(&buffer, location) == ':')
 		{
-			NSString *sequence = [lineMutable substringFromIndex:1];
+			NSString *sequence = [line substringFromIndex:(location + 1)];
 
 			[parameters addObject:sequence];
 
@@ -274,32 +542,29 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 		}
 		else
 		{
-			NSString *sequence = lineMutable.token;
+			NSRange sequenceRange;
+
+			location = _IRCMessageScanToken(&buffer, location, length, &sequenceRange);
+
+			NSString *sequence = [line substringWithRange:sequenceRange];
 
 			[parameters addObject:sequence];
 		}
 	}
 
-	self->_params = [parameters copy];
-
-	/* Return success */
-	return YES;
+	return [parameters copy];
 }
 
-- (void)parseExtensions:(NSString *)extensionInfo forClient:(nullable IRCClient *)client
+- (void)parseExtensionsInRange:(NSRange)extensionRange ofLine:(NSString *)line forClient:(nullable IRCClient *)client
 {
-	NSParameterAssert(extensionInfo != nil);
+	NSParameterAssert(line != nil);
 
-	/* Chop the tags up using ; as a divider as defined by the syntax
-	 located at: <http://ircv3.net/specs/core/message-tags-3.2.html> */
-	/* An example grouping would look like the following:
-	 @aaa=bbb;ccc;example.com/ddd=eee */
-	NSDictionary<NSString *, NSString *> *extensions =
-	[extensionInfo formDataUsingSeparator:@";" decodingBlock:^NSString *(NSString *value) {
-		return value.decodedMessageTagString;
-	}];
+	/* Tags are not decoded here. IRCMessageTags scans the raw
+	 tag section for a key when it is asked for and unescapes
+	 only the value of that key. */
+	IRCMessageTags *extensions = [[IRCMessageTags alloc] initWithLine:line range:extensionRange];
 
-	self->_messageTags = [extensions copy];
+	self->_messageTags = extensions;
 
 	/* If there is no client, then further processing is not possible */
 	if (client == nil) {
@@ -321,7 +586,11 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 		if (dateString) {
 			NSDate *dateObject = nil;
 
-			if ([dateString onlyContainsCharactersFromCharacterSet:[NSCharacterSet ZeroToNineDecimalCharacterSet]]) {
+			NSTimeInterval dateInterval = 0;
+
+			if (TXParseISOStandardDateString(dateString, &dateInterval)) {
+				dateObject = [NSDate dateWithTimeIntervalSince1970:dateInterval];
+			} else if ([dateString onlyContainsCharactersFromCharacterSet:[NSCharacterSet ZeroToNineDecimalCharacterSet]]) {
 				dateObject = [NSDate dateWithTimeIntervalSince1970:dateString.doubleValue];
 			} else {
 				dateObject = [TXSharedISOStandardDateFormatter() dateFromString:dateString];
@@ -350,26 +619,199 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 {
 	NSParameterAssert(senderInfo != nil);
 
-	IRCPrefixMutable *sender = [IRCPrefixMutable new];
+	self->_sender = IRCMessageParseSender(senderInfo, client);
+}
 
-	NSString *senderNickname = nil;
-	NSString *senderUsername = nil;
-	NSString *senderAddress = nil;
+@end
 
-	sender.hostmask = senderInfo;// Declare entire section as host
+#pragma mark -
 
-	/* Parse the user info into their appropriate sections or return NO if we can't. */
-	if ([senderInfo hostmaskComponents:&senderNickname username:&senderUsername address:&senderAddress onClient:client]) {
-		sender.nickname = senderNickname;
-		sender.username = senderUsername;
-		sender.address = senderAddress;
-	} else {
-		sender.nickname = senderInfo;
+@implementation IRCMessageTags
+{
+	NSString *_line;
+	NSRange _range;
+	void * _Nullable _Atomic _allTags; // NSDictionary<NSString *, NSString *>
+}
 
-		sender.isServer = YES;
+- (instancetype)initWithLine:(NSString *)line range:(NSRange)range
+{
+	NSParameterAssert(line != nil);
+	NSParameterAssert(NSMaxRange(range) <= line.length);
+
+	if ((self = [super init])) {
+		self->_line = [line copy];
+
+		self->_range = range;
+
+		return self;
+	}
+
+	return nil;
+}
+
+/* Tags are chopped up using ; as a divider as defined by the syntax
+ located at: <http://ircv3.net/specs/core/message-tags-3.2.html> */
+/* An example grouping would look like the following:
+ @aaa=bbb;ccc;example.com/ddd=eee */
+- (void)enumerateTagsUsingBlock:(void (NS_NOESCAPE ^)(CFStringInlineBuffer *buffer, NSRange keyRange, NSRange valueRange))enumerationBlock
+{
+	NSParameterAssert(enumerationBlock != nil);
+
+	NSUInteger location = self->_range.location;
+
+	NSUInteger rangeEnd = NSMaxRange(self->_range);
+
+	CFStringInlineBuffer buffer;
+
+	CFStringInitInlineBuffer((__bridge CFStringRef)self->_line, &buffer, CFRangeMake(0, rangeEnd));
+
+	while (location < rangeEnd) {
+		NSUInteger keyEnd = location;
+
+		while (keyEnd < rangeEnd) {
+			UniChar character = CFStringGetCharacterFromInlineBuffer(&buffer, keyEnd);
+
+			if (character == ';' || character == '=') {
+				break;
+			}
+
+			keyEnd++;
+		}
+
+		NSUInteger valueStart = keyEnd;
+		NSUInteger valueEnd = keyEnd;
+
+		if (keyEnd < rangeEnd && CFStringGetCharacterFromInlineBuffer(&buffer, keyEnd) == '=') {
+			valueStart = (keyEnd + 1);
+
+			valueEnd = valueStart;
+
+			while (valueEnd < rangeEnd && CFStringGetCharacterFromInlineBuffer(&buffer, valueEnd) != ';') {
+				valueEnd++;
+			}
+		}
+
+		if (keyEnd > location) {
+			enumerationBlock(&buffer, NSMakeRange(location, (keyEnd - location)), NSMakeRange(valueStart, (valueEnd - valueStart)));
+		}
+
+		location = (valueEnd + 1);
+	}
+}
+
+- (NSString *)valueInRange:(NSRange)valueRange
+{
+	if (valueRange.length == 0) {
+		return @"";
 	}
 
-	self->_sender = [sender copy];
+	NSString *value = [self->_line substringWithRange:valueRange];
+
+	/* Only values containing an escape sequence need decoding */
+	if ([value rangeOfString:@"\\"].location == NSNotFound) {
+		return value;
+	}
+
+	return value.decodedMessageTagString;
+}
+
+- (nullable NSString *)objectForKey:(id)aKey
+{
+	NSParameterAssert(aKey != nil);
+
+	if ([aKey isKindOfClass:[NSString class]] == NO) {
+		return nil;
+	}
+
+	NSDictionary<NSString *, NSString *> *allTags = IRCMessageLoadPublishedObject(&self->_allTags);
+
+	if (allTags) {
+		return allTags[aKey];
+	}
+
+	NSString *key = aKey;
+
+	NSUInteger keyLength = key.length;
+
+	/* Keys are compared against a copy on the stack. Keys which
+	 are too long to fit take the slow path of creating a string. */
+	UniChar keyCharacters[64];
+
+	BOOL keyFitsBuffer = (keyLength <= (sizeof(keyCharacters) / sizeof(UniChar)));
+
+	if (keyFitsBuffer) {
+		[key getCharacters:keyCharacters range:NSMakeRange(0, keyLength)];
+	}
+
+	__block NSRange matchedValueRange = NSMakeRange(NSNotFound, 0);
+
+	/* When a key is repeated, the last occurrence wins. */
+	[self enumerateTagsUsingBlock:^(CFStringInlineBuffer *buffer, NSRange keyRange, NSRange valueRange) {
+		if (keyRange.length != keyLength) {
+			return;
+		}
+
+		if (keyFitsBuffer == NO) {
+			if ([[self->_line substringWithRange:keyRange] isEqualToString:key]) {
+				matchedValueRange = valueRange;
+			}
+
+			return;
+		}
+
+		for (NSUInteger i = 0; i < keyLength; i++) {
+			if (CFStringGetCharacterFromInlineBuffer(buffer, (keyRange.location + i)) != keyCharacters[i]) {
+				return;
+			}
+		}
+
+		matchedValueRange = valueRange;
+	}];
+
+	if (matchedValueRange.location == NSNotFound) {
+		return nil;
+	}
+
+	return [self valueInRange:matchedValueRange];
+}
+
+- (void)dealloc
+{
+	IRCMessageReplacePublishedObject(&self->_allTags, nil);
+}
+
+- (NSDictionary<NSString *, NSString *> *)allTags
+{
+	NSDictionary<NSString *, NSString *> *allTags = IRCMessageLoadPublishedObject(&self->_allTags);
+
+	if (allTags) {
+		return allTags;
+	}
+
+	NSMutableDictionary<NSString *, NSString *> *allTagsMutable = [NSMutableDictionary dictionary];
+
+	[self enumerateTagsUsingBlock:^(CFStringInlineBuffer *buffer, NSRange keyRange, NSRange valueRange) {
+		NSString *key = [self->_line substringWithRange:keyRange];
+
+		allTagsMutable[key] = [self valueInRange:valueRange];
+	}];
+
+	return IRCMessagePublishObject(&self->_allTags, [allTagsMutable copy]);
+}
+
+- (NSUInteger)count
+{
+	return self.allTags.count;
+}
+
+- (NSEnumerator *)keyEnumerator
+{
+	return self.allTags.keyEnumerator;
+}
+
+- (id)copyWithZone:(nullable NSZone *)zone
+{
+	return self;
 }
 
 @end
@@ -412,6 +854,8 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 
 	if (self->_command != command) {
 		self->_command = [command copy];
+
+		self->_remoteCommand = IRCRemoteCommandFromString(command);
 	}
 }
 
@@ -454,9 +898,9 @@ DESIGNATED_INITIALIZER_EXCEPTION_BODY_END
 {
 	NSParameterAssert(params != nil);
 
-	if (self->_params != params) {
-		self->_params = [params copy];
-	}
+	IRCMessageReplacePublishedObject(&self->_params, [params copy]);
+
+	self->_paramsLine = nil;
 }
 
 - (void)setReceivedAt:(NSDate *)receivedAt
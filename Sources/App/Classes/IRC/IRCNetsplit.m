@@ -0,0 +1,217 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "NSStringHelper.h"
+#import "IRCNetsplitPrivate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface IRCNetsplit ()
+@property (nonatomic, assign, readwrite) IRCNetsplitType type;
+@property (nonatomic, copy, readwrite) NSString *servers;
+@property (nonatomic, copy, readwrite) NSDate *receivedAt;
+@property (nonatomic, strong) NSMutableArray<IRCChannel *> *channelsOrdered;
+@property (nonatomic, strong) NSMapTable<IRCChannel *, NSMutableArray<IRCChannelUser *> *> *membersByChannel;
+@property (nonatomic, strong) NSMapTable<IRCChannel *, NSMutableArray<NSString *> *> *nicknamesByChannel;
+@end
+
+@implementation IRCNetsplit
+
+- (instancetype)init
+{
+	[self doesNotRecognizeSelector:_cmd];
+
+	return nil;
+}
+
+- (instancetype)initWithType:(IRCNetsplitType)type servers:(NSString *)servers receivedAt:(NSDate *)receivedAt
+{
+	NSParameterAssert(servers != nil);
+	NSParameterAssert(receivedAt != nil);
+
+	if ((self = [super init])) {
+		self.type = type;
+
+		self.servers = servers;
+
+		self.receivedAt = receivedAt;
+
+		[self prepareInitialState];
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (void)prepareInitialState
+{
+	self.channelsOrdered = [NSMutableArray array];
+
+	self.membersByChannel = [NSMapTable strongToStrongObjectsMapTable];
+
+	self.nicknamesByChannel = [NSMapTable strongToStrongObjectsMapTable];
+}
+
+- (NSArray<IRCChannel *> *)channels
+{
+	return [self.channelsOrdered copy];
+}
+
+- (void)addChannelIfNeeded:(IRCChannel *)channel
+{
+	if ([self.membersByChannel objectForKey:channel] != nil) {
+		return;
+	}
+
+	[self.channelsOrdered addObject:channel];
+
+	[self.membersByChannel setObject:[NSMutableArray array] forKey:channel];
+
+	[self.nicknamesByChannel setObject:[NSMutableArray array] forKey:channel];
+}
+
+- (void)addMember:(IRCChannelUser *)member toChannel:(IRCChannel *)channel
+{
+	NSParameterAssert(member != nil);
+	NSParameterAssert(channel != nil);
+
+	[self addChannelIfNeeded:channel];
+
+	[[self.membersByChannel objectForKey:channel] addObject:member];
+}
+
+- (void)addNicknameToPrint:(NSString *)nickname inChannel:(IRCChannel *)channel
+{
+	NSParameterAssert(nickname != nil);
+	NSParameterAssert(channel != nil);
+
+	[self addChannelIfNeeded:channel];
+
+	[[self.nicknamesByChannel objectForKey:channel] addObject:nickname];
+}
+
+- (NSArray<IRCChannelUser *> *)membersInChannel:(IRCChannel *)channel
+{
+	NSParameterAssert(channel != nil);
+
+	NSArray *members = [self.membersByChannel objectForKey:channel];
+
+	if (members == nil) {
+		return @[];
+	}
+
+	return [members copy];
+}
+
+- (NSArray<NSString *> *)nicknamesToPrintInChannel:(IRCChannel *)channel
+{
+	NSParameterAssert(channel != nil);
+
+	NSArray *nicknames = [self.nicknamesByChannel objectForKey:channel];
+
+	if (nicknames == nil) {
+		return @[];
+	}
+
+	return [nicknames copy];
+}
+
+- (NSString *)firstServer
+{
+	return [self.servers componentsSeparatedByString:@" "].firstObject;
+}
+
+- (NSString *)secondServer
+{
+	return [self.servers componentsSeparatedByString:@" "].lastObject;
+}
+
++ (nullable NSString *)serversInQuitComment:(NSString *)comment
+{
+	NSParameterAssert(comment != nil);
+
+	/* Quit messages set by users are prefixed with "Quit: " on
+	 most servers which means they can't be made to look like this. */
+	NSArray *servers = [comment componentsSeparatedByString:@" "];
+
+	if (servers.count != 2) {
+		return nil;
+	}
+
+	NSString *server1 = servers[0];
+	NSString *server2 = servers[1];
+
+	if ([self isServerName:server1] == NO ||
+		[self isServerName:server2] == NO)
+	{
+		return nil;
+	}
+
+	if ([server1 isEqualToStringIgnoringCase:server2]) {
+		return nil;
+	}
+
+	return comment;
+}
+
++ (BOOL)isServerName:(NSString *)serverName
+{
+	NSParameterAssert(serverName != nil);
+
+	if (serverName.length < 3) {
+		return NO;
+	}
+
+	if ([serverName hasPrefix:@"."] || [serverName hasSuffix:@"."]) {
+		return NO;
+	}
+
+	if ([serverName contains:@"."] == NO) {
+		return NO;
+	}
+
+	if ([serverName contains:@"/"] || [serverName contains:@":"]) {
+		return NO;
+	}
+
+	return YES;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,161 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "IRCClient.h"
+#import "IRCMessageInternal.h"
+#import "IRCPrefix.h"
+#import "IRCPrefixCachePrivate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define _cacheSlotCount			1024
+
+@interface IRCPrefixCache ()
+{
+	__strong IRCPrefix *_cachedPrefixes[_cacheSlotCount];
+	NSUInteger _cachedPrefixHashes[_cacheSlotCount];
+}
+
+@property (nonatomic, weak, readwrite) IRCClient *client;
+@property (nonatomic, assign, readwrite) NSUInteger cacheHits;
+@property (nonatomic, assign, readwrite) NSUInteger cacheMisses;
+@end
+
+@implementation IRCPrefixCache
+
+- (instancetype)initWithClient:(IRCClient *)client
+{
+	NSParameterAssert(client != nil);
+
+	if ((self = [super init])) {
+		self.client = client;
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (void)clearCachedPrefixes
+{
+	@synchronized (self) {
+		if (self.cacheHits > 0 || self.cacheMisses > 0) {
+			LogToConsoleDebug("Prefix cache hit rate: %.1f%% (%lu hits, %lu misses)",
+				(self.cacheHitRate * 100.0), self.cacheHits, self.cacheMisses);
+		}
+
+		for (NSUInteger i = 0; i < _cacheSlotCount; i++) {
+			self->_cachedPrefixes[i] = nil;
+		}
+
+		self.cacheHits = 0;
+		self.cacheMisses = 0;
+	}
+}
+
+- (double)cacheHitRate
+{
+	@synchronized (self) {
+		NSUInteger lookups = (self.cacheHits + self.cacheMisses);
+
+		if (lookups == 0) {
+			return 0.0;
+		}
+
+		return ((double)self.cacheHits / (double)lookups);
+	}
+}
+
+- (IRCPrefix *)prefixInRange:(NSRange)range ofLine:(NSString *)line
+{
+	NSParameterAssert(line != nil);
+	NSParameterAssert(NSMaxRange(range) <= line.length);
+
+	CFStringInlineBuffer buffer;
+
+	CFStringInitInlineBuffer((__bridge CFStringRef)line, &buffer, CFRangeMake(range.location, range.length));
+
+	/* FNV-1a */
+	NSUInteger hash = 2166136261;
+
+	for (NSUInteger i = 0; i < range.length; i++) {
+		hash ^= CFStringGetCharacterFromInlineBuffer(&buffer, i);
+
+		hash *= 16777619;
+	}
+
+	NSUInteger slot = (hash & (_cacheSlotCount - 1));
+
+	@synchronized (self) {
+		IRCPrefix *cachedPrefix = self->_cachedPrefixes[slot];
+
+		if (cachedPrefix && self->_cachedPrefixHashes[slot] == hash) {
+			NSString *hostmask = cachedPrefix.hostmask;
+
+			if (hostmask.length == range.length &&
+				[line compare:hostmask options:NSLiteralSearch range:range] == NSOrderedSame)
+			{
+				self.cacheHits += 1;
+
+				return cachedPrefix;
+			}
+		}
+
+		self.cacheMisses += 1;
+	}
+
+	IRCPrefix *prefix = [self prefixWithHostmask:[line substringWithRange:range]];
+
+	@synchronized (self) {
+		self->_cachedPrefixes[slot] = prefix;
+
+		self->_cachedPrefixHashes[slot] = hash;
+	}
+
+	return prefix;
+}
+
+- (IRCPrefix *)prefixWithHostmask:(NSString *)hostmask
+{
+	NSParameterAssert(hostmask != nil);
+
+	return IRCMessageParseSender(hostmask, self.client);
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
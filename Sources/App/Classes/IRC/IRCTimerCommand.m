@@ -117,6 +117,8 @@ static NSUInteger IRCTimedCommandLastIdentifier = 0;
 	[TLOTimer timerWithActionBlock:^(TLOTimer * _Nonnull sender) {
 		[client onTimedCommand:weakSelf];
 	}];
+
+	self.timer.timerWheel = client.timerWheel;
 }
 
 - (void)start:(NSTimeInterval)timerInterval
@@ -286,19 +286,18 @@ NS_ASSUME_NONNULL_BEGIN
 		return NSOrderedDescending;
 	}
 
-	NSNumber *localRank = @([self channelRank]);
+	/* Higher ranks are sorted first */
+	NSUInteger localRank = [self channelRank];
 
-	NSNumber *remoteRank = @([other channelRank]);
+	NSUInteger remoteRank = [other channelRank];
 
-	NSComparisonResult normalRank = [localRank compare:remoteRank];
-
-	NSComparisonResult invertedRank = NSInvertedComparisonResult(normalRank);
-
-	if (invertedRank == NSOrderedSame) {
-		return [self.user.nickname caseInsensitiveCompare:other.user.nickname];
+	if (localRank > remoteRank) {
+		return NSOrderedAscending;
+	} else if (localRank < remoteRank) {
+		return NSOrderedDescending;
 	}
 
-	return invertedRank;
+	return [self.user.nickname caseInsensitiveCompare:other.user.nickname];
 }
 
 + (NSComparator)channelRankComparator
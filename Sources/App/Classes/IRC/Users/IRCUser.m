@@ -38,7 +38,8 @@
 
 #import "NSObjectHelperPrivate.h"
 #import "TPCPreferencesLocal.h"
-#import "IRCClient.h"
+#import "TLOTimerWheel.h"
+#import "IRCClientPrivate.h"
 #import "IRCUserPersistentStorePrivate.h"
 #import "IRCUserRelationsPrivate.h"
 #import "IRCUserInternal.h"
@@ -46,7 +47,7 @@
 NS_ASSUME_NONNULL_BEGIN
 
 /* IRCUser has an internal timer that is started when relations reach zero.
- This timer runs for five minutes, using a GCD timer. When the timer fires,
+ This timer runs for five minutes, using the timer wheel of the client. When it fires,
  it removes the user from the client, thus remove any trace of it. */
 #define _removeUserTimerInterval					(60 * 5) // 5 minutes
 
@@ -265,7 +266,7 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	/* If the timer is already active, we reset the block that is scheduled
 	 so that the user that is targeted is always the primary */
-	dispatch_source_t removeUserTimer = self.persistentStore.removeUserTimer;
+	TLOTimerWheelEntry *removeUserTimer = self.persistentStore.removeUserTimer;
 
 	if (removeUserTimer == nil) {
 		return;
@@ -273,7 +274,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 	dispatch_block_t blockToFire = [self removeUserTimerBlockToFire];
 
-	dispatch_source_set_event_handler(removeUserTimer, blockToFire);
+	[self.client.timerWheel replaceBlock:blockToFire forEntry:removeUserTimer];
 }
 
 - (void)toggleRemoveUserTimer
@@ -287,19 +288,17 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)startRemoveUserTimer
 {
-	dispatch_source_t removeUserTimer = self.persistentStore.removeUserTimer;
+	TLOTimerWheelEntry *removeUserTimer = self.persistentStore.removeUserTimer;
 
-	if (removeUserTimer != NULL) {
+	if (removeUserTimer != nil) {
 		return;
 	}
 
 	dispatch_block_t blockToFire = [self removeUserTimerBlockToFire];
 
-	removeUserTimer = XRScheduleBlockOnGlobalQueue(blockToFire, _removeUserTimerInterval);
+	removeUserTimer = [self.client.timerWheel scheduleBlock:blockToFire afterDelay:_removeUserTimerInterval];
 
-	XRResumeScheduledBlock(removeUserTimer);
-
-	if (removeUserTimer == NULL) {
+	if (removeUserTimer == nil) {
 		LogToConsoleError("Failed to create timer to remove user");
 
 		blockToFire(); // Remove user if timer isn't available
@@ -312,13 +311,13 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)cancelRemoveUserTimer
 {
-	dispatch_source_t removeUserTimer = self.persistentStore.removeUserTimer;
+	TLOTimerWheelEntry *removeUserTimer = self.persistentStore.removeUserTimer;
 
 	if (removeUserTimer == nil) {
 		return;
 	}
 
-	XRCancelScheduledBlock(removeUserTimer);
+	[self.client.timerWheel cancelEntry:removeUserTimer];
 
 	self.persistentStore.removeUserTimer = nil;
 }
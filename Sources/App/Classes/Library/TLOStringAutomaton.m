@@ -0,0 +1,348 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "TLOStringAutomatonPrivate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/* Each node of the trie is one character into one or more strings.
+ Transitions are kept in a single dictionary keyed by the node and
+ the character. Failure links are computed when the automaton is
+ prepared instead of each time a string is added. */
+#define _noString		UINT32_MAX
+
+typedef struct {
+	unichar character;
+	uint32_t firstChild;
+	uint32_t nextSibling;
+	uint32_t failure;
+	uint32_t outputLink; // Nearest node along failure links that ends a string
+	uint32_t string;
+} TLOStringAutomatonNode;
+
+@interface TLOStringAutomaton ()
+{
+	TLOStringAutomatonNode *_nodes;
+	uint32_t _nodesCount;
+	uint32_t _nodesCapacity;
+
+	NSUInteger *_stringLengths;
+	NSUInteger _stringLengthsCapacity;
+}
+
+@property (nonatomic, assign) CFMutableDictionaryRef transitions;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *stringIndexes;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfStrings;
+@property (nonatomic, assign) BOOL prepared;
+@end
+
+@implementation TLOStringAutomaton
+
+- (instancetype)init
+{
+	if ((self = [super init])) {
+		[self prepareInitialState];
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (void)prepareInitialState
+{
+	self.transitions = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+
+	self.stringIndexes = [NSMutableDictionary dictionary];
+
+	self->_nodesCapacity = 64;
+
+	self->_nodes = calloc(self->_nodesCapacity, sizeof(TLOStringAutomatonNode));
+
+	/* Root node */
+	self->_nodesCount = 1;
+
+	self->_nodes[0].string = _noString;
+
+	self->_stringLengthsCapacity = 16;
+
+	self->_stringLengths = calloc(self->_stringLengthsCapacity, sizeof(NSUInteger));
+}
+
+- (void)dealloc
+{
+	CFRelease(self->_transitions);
+
+	free(self->_nodes);
+
+	free(self->_stringLengths);
+}
+
+NS_INLINE const void *_transitionKey(uint32_t node, unichar character)
+{
+	/* One is added so that no key is NULL */
+	return (const void *)(uintptr_t)((((uint64_t)node << 16) | character) + 1);
+}
+
+NS_INLINE uint32_t _transition(CFDictionaryRef transitions, uint32_t node, unichar character)
+{
+	return (uint32_t)(uintptr_t)CFDictionaryGetValue(transitions, _transitionKey(node, character));
+}
+
+- (NSUInteger)addString:(NSString *)string
+{
+	NSParameterAssert(string != nil);
+
+	NSUInteger stringLength = string.length;
+
+	NSParameterAssert(stringLength > 0);
+
+	NSNumber *stringIndex = self.stringIndexes[string];
+
+	if (stringIndex) {
+		return stringIndex.unsignedIntegerValue;
+	}
+
+	/* Strings are read through an inline buffer instead of being copied
+	 onto the stack, which has no bound on the length of the string. */
+	CFStringInlineBuffer characters;
+
+	CFStringInitInlineBuffer((__bridge CFStringRef)string, &characters, CFRangeMake(0, stringLength));
+
+	CFMutableDictionaryRef transitions = self.transitions;
+
+	uint32_t node = 0;
+
+	for (NSUInteger i = 0; i < stringLength; i++) {
+		unichar character = CFStringGetCharacterFromInlineBuffer(&characters, i);
+
+		uint32_t child = _transition(transitions, node, character);
+
+		if (child == 0) {
+			if (self->_nodesCount == self->_nodesCapacity) {
+				self->_nodesCapacity *= 2;
+
+				self->_nodes = realloc(self->_nodes, (self->_nodesCapacity * sizeof(TLOStringAutomatonNode)));
+			}
+
+			child = self->_nodesCount;
+
+			self->_nodesCount += 1;
+
+			TLOStringAutomatonNode *childNode = &self->_nodes[child];
+
+			childNode->character = character;
+			childNode->firstChild = 0;
+			childNode->nextSibling = self->_nodes[node].firstChild;
+			childNode->failure = 0;
+			childNode->outputLink = 0;
+			childNode->string = _noString;
+
+			self->_nodes[node].firstChild = child;
+
+			CFDictionarySetValue(transitions, _transitionKey(node, character), (const void *)(uintptr_t)child);
+		}
+
+		node = child;
+	}
+
+	NSUInteger newStringIndex = self.numberOfStrings;
+
+	if (newStringIndex == self->_stringLengthsCapacity) {
+		self->_stringLengthsCapacity *= 2;
+
+		self->_stringLengths = realloc(self->_stringLengths, (self->_stringLengthsCapacity * sizeof(NSUInteger)));
+	}
+
+	self->_stringLengths[newStringIndex] = stringLength;
+
+	/* The node may already exist as part of a longer string in which
+	 case nodes that link to it must learn that it ends a string. */
+	self->_nodes[node].string = (uint32_t)newStringIndex;
+
+	self.stringIndexes[string] = @(newStringIndex);
+
+	self.numberOfStrings = (newStringIndex + 1);
+
+	self.prepared = NO;
+
+	return newStringIndex;
+}
+
+- (NSUInteger)lengthOfStringAtIndex:(NSUInteger)index
+{
+	NSParameterAssert(index < self.numberOfStrings);
+
+	return self->_stringLengths[index];
+}
+
+- (void)prepare
+{
+	if (self.prepared) {
+		return;
+	}
+
+	CFMutableDictionaryRef transitions = self.transitions;
+
+	TLOStringAutomatonNode *nodes = self->_nodes;
+
+	uint32_t *queue = malloc(self->_nodesCount * sizeof(uint32_t));
+
+	uint32_t queueHead = 0;
+	uint32_t queueTail = 0;
+
+	for (uint32_t child = nodes[0].firstChild; child != 0; child = nodes[child].nextSibling) {
+		nodes[child].failure = 0;
+		nodes[child].outputLink = 0;
+
+		queue[queueTail++] = child;
+	}
+
+	while (queueHead < queueTail) {
+		uint32_t parent = queue[queueHead++];
+
+		for (uint32_t child = nodes[parent].firstChild; child != 0; child = nodes[child].nextSibling) {
+			unichar character = nodes[child].character;
+
+			uint32_t failure = nodes[parent].failure;
+
+			uint32_t failureChild = _transition(transitions, failure, character);
+
+			while (failureChild == 0 && failure != 0) {
+				failure = nodes[failure].failure;
+
+				failureChild = _transition(transitions, failure, character);
+			}
+
+			nodes[child].failure = failureChild;
+
+			if (nodes[failureChild].string != _noString) {
+				nodes[child].outputLink = failureChild;
+			} else {
+				nodes[child].outputLink = nodes[failureChild].outputLink;
+			}
+
+			queue[queueTail++] = child;
+		}
+	}
+
+	free(queue);
+
+	self.prepared = YES;
+}
+
+- (void)enumerateMatchesInString:(NSString *)string withBlock:(void (NS_NOESCAPE ^)(NSUInteger stringIndex, NSRange range))block
+{
+	NSParameterAssert(string != nil);
+	NSParameterAssert(block != NULL);
+
+	if (self.numberOfStrings == 0) {
+		return;
+	}
+
+	[self prepare];
+
+	CFDictionaryRef transitions = self.transitions;
+
+	const TLOStringAutomatonNode *nodes = self->_nodes;
+
+	const NSUInteger *stringLengths = self->_stringLengths;
+
+	/* The end of the last occurrence of each string so that an occurrence
+	 overlapping it can be skipped. Matches are rare compared to the
+	 number of strings so a dictionary is cheaper than a slot each. */
+	NSMutableDictionary<NSNumber *, NSNumber *> *lastMatchEnds = nil;
+
+	NSUInteger length = string.length;
+
+	CFStringInlineBuffer characters;
+
+	CFStringInitInlineBuffer((__bridge CFStringRef)string, &characters, CFRangeMake(0, length));
+
+	uint32_t node = 0;
+
+	for (NSUInteger i = 0; i < length; i++) {
+		unichar character = CFStringGetCharacterFromInlineBuffer(&characters, i);
+
+		uint32_t nextNode = _transition(transitions, node, character);
+
+		while (nextNode == 0 && node != 0) {
+			node = nodes[node].failure;
+
+			nextNode = _transition(transitions, node, character);
+		}
+
+		node = nextNode;
+
+		uint32_t outputNode = node;
+
+		if (nodes[outputNode].string == _noString) {
+			outputNode = nodes[outputNode].outputLink;
+		}
+
+		while (outputNode != 0) {
+			uint32_t stringIndex = nodes[outputNode].string;
+
+			outputNode = nodes[outputNode].outputLink;
+
+			NSUInteger stringLength = stringLengths[stringIndex];
+
+			NSUInteger location = (i + 1 - stringLength);
+
+			if (lastMatchEnds == nil) {
+				lastMatchEnds = [NSMutableDictionary dictionary];
+			}
+
+			NSNumber *stringKey = @(stringIndex);
+
+			NSNumber *lastMatchEnd = lastMatchEnds[stringKey];
+
+			if (lastMatchEnd && location < lastMatchEnd.unsignedIntegerValue) {
+				continue;
+			}
+
+			lastMatchEnds[stringKey] = @(i + 1);
+
+			block(stringIndex, NSMakeRange(location, stringLength));
+		}
+	}
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
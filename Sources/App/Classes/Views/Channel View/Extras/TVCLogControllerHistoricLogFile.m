@@ -186,6 +186,11 @@ NS_ASSUME_NONNULL_BEGIN
 						argumentIndex:0
 							  ofReply:YES];
 
+	[remoteObjectInterface setClasses:[NSSet setWithObjects:[NSArray class], [TVCLogLineXPC class], nil]
+						  forSelector:@selector(writeLogLines:)
+						argumentIndex:0
+							  ofReply:NO];
+
 	serviceConnection.remoteObjectInterface = remoteObjectInterface;
 
 	NSXPCInterface *exportedInterface = [NSXPCInterface interfaceWithProtocol:@protocol(HLSHistoricLogClientProtocol)];
@@ -475,6 +480,28 @@ NS_ASSUME_NONNULL_BEGIN
 	[[self remoteObjectProxy] writeLogLine:newEntry];
 }
 
+- (void)writeNewEntriesWithLogLines:(NSArray<TVCLogLine *> *)logLines forItem:(IRCTreeItem *)item
+{
+	NSParameterAssert(logLines != nil);
+	NSParameterAssert(item != nil);
+
+	if (logLines.count == 0) {
+		return;
+	}
+
+	[self warmProcessIfNeeded];
+
+	NSMutableArray<TVCLogLineXPC *> *newEntries = [NSMutableArray arrayWithCapacity:logLines.count];
+
+	for (TVCLogLine *logLine in logLines) {
+		TVCLogLineXPC *newEntry = [logLine xpcObjectForTreeItem:item];
+
+		[newEntries addObject:newEntry];
+	}
+
+	[[self remoteObjectProxy] writeLogLines:[newEntries copy]];
+}
+
 #pragma mark -
 #pragma mark Private API (Client)
 
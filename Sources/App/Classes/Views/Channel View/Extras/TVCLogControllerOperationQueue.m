@@ -43,6 +43,32 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
+/* Lines printed to a view are rendered in the order they were printed.
+ Lines printed to different views have no relation to one another which
+ means they are rendered in parallel. Each view is given a lane that is
+ a list of its operations. A lane with operations is drained by one
+ worker at a time on a concurrent queue, which keeps its order, while
+ any number of lanes are drained at the same time. */
+/* A lane gives up its worker after a few operations and is scheduled
+ again so that a busy view does not starve the others. */
+#define _laneDrainBatchSize			16
+
+/* The number of operations a client can have waiting in lanes before
+ -waitForRenderBudgetForClient: blocks the caller. The protocol layer
+ waits on this before processing lines it has received which slows
+ down reading from that server while rendering catches up. Each client
+ has a budget of its own so that a busy client does not slow down
+ reading for any other. */
+#define _renderBudget				2048
+
+/* Waiting for the budget gives up after this long so that rendering
+ which is stuck for any reason never stalls the connection for good. */
+#define _renderBudgetMaximumWait	1.0
+
+/* Waiting for lines to be rendered gives up after this long.
+ Only the traffic replay waits for this. */
+#define _renderCompletionMaximumWait	60.0
+
 #pragma mark -
 #pragma mark Define Private Header
 
@@ -51,19 +77,40 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, weak) TVCLogController *viewController;
 @property (readonly, getter=isPending) BOOL pending;
 @property (nonatomic, assign, getter=isStandalone) BOOL standalone;
+
+- (void)executeBlock;
+@end
+
+@interface TVCLogControllerPrintingLane : NSObject
+@property (nonatomic, copy) NSString *laneKey;
+@property (nonatomic, copy, nullable) NSString *clientIdentifier;
+@property (nonatomic, weak) TVCLogController *viewController;
+@property (nonatomic, strong) NSMutableArray<TVCLogControllerPrintingOperation *> *operations;
+@property (nonatomic, assign) BOOL draining;
+@property (nonatomic, assign) NSUInteger budgetInUse;
 @end
 
 @interface TVCLogControllerPrintingOperationQueue ()
-/* This queue is application wide and stores all printing operations. 
- Having a single queue gives us greater control over what happens,
- instead of trying to optimize one queue per-server. */
-/* One problem of having a single queue through, is indexing which
- operations are associated with which view controller. To make this
- task easier, we maintain our own internal cache of pending operations
- which we can query at any time to know whats happening. The queue
- then observes the isFinished property to know when to remove the
- operations from our internal cache. */
+/* Standalone operations do not depend on any other operation which
+ means they are added to the underlying NSOperationQueue as is. We
+ maintain our own internal cache of these pending operations which we
+ can query at any time to know whats happening. The queue then observes
+ the isFinished property to know when to remove the operations from
+ our internal cache. */
 @property (nonatomic, strong) NSMutableDictionary<NSString *, NSMutableArray *> *pendingOperations;
+
+/* Lanes are keyed by the description of their view controller */
+@property (nonatomic, strong) NSMutableDictionary<NSString *, TVCLogControllerPrintingLane *> *lanes;
+@property (nonatomic, strong) dispatch_queue_t lanesWorkerQueue;
+
+/* Render budget in use is keyed by the unique identifier of the client */
+@property (nonatomic, strong) NSCondition *renderBudgetCondition;
+@property (nonatomic, strong) NSMutableDictionary<NSString *, NSNumber *> *renderBudgetsInUse;
+
+/* Lane statistics are guarded by self.lanes */
+@property (nonatomic, assign) NSUInteger numberOfLanesDraining;
+@property (nonatomic, assign, readwrite) NSUInteger peakNumberOfLanesDraining;
+@property (nonatomic, assign, readwrite) CFAbsoluteTime timeSpentDrainingLanes;
 @end
 
 #pragma mark -
@@ -91,7 +138,15 @@ NS_ASSUME_NONNULL_BEGIN
 	self.pendingOperations = [NSMutableDictionary dictionary];
 
 	self.qualityOfService = NSQualityOfServiceDefault;
- }
+
+	self.lanes = [NSMutableDictionary dictionary];
+
+	self.lanesWorkerQueue = dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0);
+
+	self.renderBudgetCondition = [NSCondition new];
+
+	self.renderBudgetsInUse = [NSMutableDictionary dictionary];
+}
 
 #pragma mark -
 #pragma mark Queue Additions
@@ -118,7 +173,342 @@ NS_ASSUME_NONNULL_BEGIN
 
 	operation.viewController = viewController;
 
-	[self addPendingOperation:operation];
+	if (isStandalone) {
+		[self addPendingOperation:operation];
+	} else {
+		[self addOperationToLane:operation];
+	}
+}
+
+#pragma mark -
+#pragma mark Lanes
+
+- (void)addOperationToLane:(TVCLogControllerPrintingOperation *)operation
+{
+	NSParameterAssert(operation != nil);
+
+	TVCLogController *viewController = operation.viewController;
+
+	NSString *laneKey = viewController.description;
+
+	BOOL scheduleLane = NO;
+
+	TVCLogControllerPrintingLane *lane = nil;
+
+	NSInteger budgetChange = 0;
+
+	@synchronized (self.lanes) {
+		lane = self.lanes[laneKey];
+
+		if (lane == nil) {
+			lane = [TVCLogControllerPrintingLane new];
+
+			lane.laneKey = laneKey;
+
+			lane.clientIdentifier = viewController.associatedClient.uniqueIdentifier;
+
+			lane.operations = [NSMutableArray array];
+
+			self.lanes[laneKey] = lane;
+		}
+
+		/* The description of a view controller includes its address
+		 which can be reused by a new view controller once the one
+		 the lane was created for is deallocated. */
+		lane.viewController = viewController;
+
+		[lane.operations addObject:operation];
+
+		if (lane.draining == NO && viewController.viewIsLoaded) {
+			lane.draining = YES;
+
+			scheduleLane = YES;
+		}
+
+		budgetChange = [self updateRenderBudgetOfLane:lane];
+	}
+
+	[self adjustRenderBudgetInUse:budgetChange forClientWithIdentifier:lane.clientIdentifier];
+
+	if (scheduleLane) {
+		[self scheduleLane:lane];
+	}
+}
+
+- (void)scheduleLane:(TVCLogControllerPrintingLane *)lane
+{
+	NSParameterAssert(lane != nil);
+
+	dispatch_async(self.lanesWorkerQueue, ^{
+		@synchronized (self.lanes) {
+			self.numberOfLanesDraining += 1;
+
+			if (self.peakNumberOfLanesDraining < self.numberOfLanesDraining) {
+				self.peakNumberOfLanesDraining = self.numberOfLanesDraining;
+			}
+		}
+
+		CFAbsoluteTime drainStartTime = CFAbsoluteTimeGetCurrent();
+
+		[self drainLane:lane];
+
+		CFAbsoluteTime drainTime = (CFAbsoluteTimeGetCurrent() - drainStartTime);
+
+		@synchronized (self.lanes) {
+			self.numberOfLanesDraining -= 1;
+
+			self.timeSpentDrainingLanes += drainTime;
+		}
+	});
+}
+
+- (void)drainLane:(TVCLogControllerPrintingLane *)lane
+{
+	NSParameterAssert(lane != nil);
+
+	for (NSUInteger i = 0; i < _laneDrainBatchSize; i++) {
+		TVCLogControllerPrintingOperation *operation = nil;
+
+		NSInteger budgetChange = 0;
+
+		@synchronized (self.lanes) {
+			TVCLogController *viewController = lane.viewController;
+
+			if (viewController == nil) {
+				/* There is no one left to print to */
+				[lane.operations removeAllObjects];
+			} else if (viewController.viewIsLoaded) {
+				operation = lane.operations.firstObject;
+			}
+
+			if (operation == nil) {
+				lane.draining = NO;
+
+				[self removeLaneIfEmpty:lane];
+			}
+
+			budgetChange = [self updateRenderBudgetOfLane:lane];
+		}
+
+		[self adjustRenderBudgetInUse:budgetChange forClientWithIdentifier:lane.clientIdentifier];
+
+		if (operation == nil) {
+			return;
+		}
+
+		@autoreleasepool {
+			[operation executeBlock];
+		}
+
+		/* The operation stays in the lane while it executes so that it
+		 counts against the budget until its block has finished. */
+		@synchronized (self.lanes) {
+			[lane.operations removeObjectIdenticalTo:operation];
+
+			budgetChange = [self updateRenderBudgetOfLane:lane];
+		}
+
+		[self adjustRenderBudgetInUse:budgetChange forClientWithIdentifier:lane.clientIdentifier];
+	}
+
+	[self scheduleLane:lane];
+}
+
+- (void)cancelOperationsInLaneForViewController:(TVCLogController *)viewController
+{
+	NSParameterAssert(viewController != nil);
+
+	NSString *laneKey = viewController.description;
+
+	TVCLogControllerPrintingLane *lane = nil;
+
+	NSArray *operations = nil;
+
+	NSInteger budgetChange = 0;
+
+	@synchronized (self.lanes) {
+		lane = self.lanes[laneKey];
+
+		if (lane == nil) {
+			return;
+		}
+
+		operations = [lane.operations copy];
+
+		[lane.operations removeAllObjects];
+
+		/* A lane that is draining removes itself once it finds itself empty */
+		[self removeLaneIfEmpty:lane];
+
+		budgetChange = [self updateRenderBudgetOfLane:lane];
+	}
+
+	[operations makeObjectsPerformSelector:@selector(cancel)];
+
+	[self adjustRenderBudgetInUse:budgetChange forClientWithIdentifier:lane.clientIdentifier];
+}
+
+- (void)scheduleLaneForViewController:(TVCLogController *)viewController
+{
+	NSParameterAssert(viewController != nil);
+
+	NSString *laneKey = viewController.description;
+
+	TVCLogControllerPrintingLane *lane = nil;
+
+	NSInteger budgetChange = 0;
+
+	@synchronized (self.lanes) {
+		lane = self.lanes[laneKey];
+
+		if (lane == nil || lane.draining || lane.operations.count == 0 || viewController.viewIsLoaded == NO) {
+			return;
+		}
+
+		lane.draining = YES;
+
+		budgetChange = [self updateRenderBudgetOfLane:lane];
+	}
+
+	[self adjustRenderBudgetInUse:budgetChange forClientWithIdentifier:lane.clientIdentifier];
+
+	[self scheduleLane:lane];
+}
+
+- (void)removeLaneIfEmpty:(TVCLogControllerPrintingLane *)lane
+{
+	NSParameterAssert(lane != nil);
+
+	if (lane.draining || lane.operations.count > 0) {
+		return;
+	}
+
+	NSString *laneKey = lane.laneKey;
+
+	/* A new lane may have taken the key of this one */
+	if (self.lanes[laneKey] != lane) {
+		return;
+	}
+
+	[self.lanes removeObjectForKey:laneKey];
+}
+
+- (void)resetLaneStatistics
+{
+	@synchronized (self.lanes) {
+		self.peakNumberOfLanesDraining = self.numberOfLanesDraining;
+
+		self.timeSpentDrainingLanes = 0;
+	}
+}
+
+#pragma mark -
+#pragma mark Render Budget
+
+/* Only operations in a lane that is draining count against the budget.
+ A lane for a view which is not loaded can hold on to its operations
+ for any amount of time and waiting on those would stall reading
+ for no benefit. This method must be called while self.lanes is locked.
+ The change it returns is then handed to -adjustRenderBudgetInUse:...
+ once the lock has been released. */
+- (NSInteger)updateRenderBudgetOfLane:(TVCLogControllerPrintingLane *)lane
+{
+	NSParameterAssert(lane != nil);
+
+	NSUInteger budgetInUse = 0;
+
+	if (lane.draining) {
+		budgetInUse = lane.operations.count;
+	}
+
+	NSInteger budgetChange = ((NSInteger)budgetInUse - (NSInteger)lane.budgetInUse);
+
+	lane.budgetInUse = budgetInUse;
+
+	return budgetChange;
+}
+
+- (void)adjustRenderBudgetInUse:(NSInteger)byHowMuch forClientWithIdentifier:(nullable NSString *)clientIdentifier
+{
+	if (byHowMuch == 0 || clientIdentifier == nil) {
+		return;
+	}
+
+	NSCondition *condition = self.renderBudgetCondition;
+
+	[condition lock];
+
+	NSUInteger budgetInUse = [self.renderBudgetsInUse[clientIdentifier] unsignedIntegerValue];
+
+	if (byHowMuch < 0 && budgetInUse < (NSUInteger)(-1 * byHowMuch)) {
+		budgetInUse = 0;
+	} else {
+		budgetInUse += byHowMuch;
+	}
+
+	if (budgetInUse == 0) {
+		[self.renderBudgetsInUse removeObjectForKey:clientIdentifier];
+	} else {
+		self.renderBudgetsInUse[clientIdentifier] = @(budgetInUse);
+	}
+
+	if (byHowMuch < 0 && budgetInUse < _renderBudget) {
+		[condition broadcast];
+	}
+
+	[condition unlock];
+}
+
+- (void)waitForRenderBudgetForClient:(IRCClient *)client
+{
+	NSParameterAssert(client != nil);
+
+	/* Operations finish by performing blocks on the main thread
+	 which means waiting on the main thread could never return. */
+	if ([NSThread isMainThread]) {
+		return;
+	}
+
+	NSString *clientIdentifier = client.uniqueIdentifier;
+
+	NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:_renderBudgetMaximumWait];
+
+	NSCondition *condition = self.renderBudgetCondition;
+
+	[condition lock];
+
+	while ([self.renderBudgetsInUse[clientIdentifier] unsignedIntegerValue] >= _renderBudget) {
+		if ([condition waitUntilDate:deadline] == NO) {
+			break;
+		}
+	}
+
+	[condition unlock];
+}
+
+- (void)waitUntilLinesAreRenderedForClient:(IRCClient *)client
+{
+	NSParameterAssert(client != nil);
+
+	if ([NSThread isMainThread]) {
+		return;
+	}
+
+	NSString *clientIdentifier = client.uniqueIdentifier;
+
+	NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:_renderCompletionMaximumWait];
+
+	NSCondition *condition = self.renderBudgetCondition;
+
+	[condition lock];
+
+	while ([self.renderBudgetsInUse[clientIdentifier] unsignedIntegerValue] > 0) {
+		if ([condition waitUntilDate:deadline] == NO) {
+			break;
+		}
+	}
+
+	[condition unlock];
 }
 
 #pragma mark -
@@ -147,10 +537,7 @@ NS_ASSUME_NONNULL_BEGIN
 {
 	NSParameterAssert(operation != nil);
 
-	TVCLogControllerPrintingOperation *operationDependency = nil;
-
-	/* Add operation to list of pending operations and while we have those,
-	 also pick out what will be its dependency. */
+	/* Add operation to list of pending operations */
 	NSString *pendingOperationsKey = operation.viewController.description;
 
 	@synchronized (self.pendingOperations) {
@@ -160,26 +547,11 @@ NS_ASSUME_NONNULL_BEGIN
 			pendingOperations = [NSMutableArray array];
 
 			self.pendingOperations[pendingOperationsKey] = pendingOperations;
-		} else {
-			for (TVCLogControllerPrintingOperation *pendingOperation in pendingOperations.reverseObjectEnumerator) {
-				if (pendingOperation.isCancelled || pendingOperation.isStandalone) {
-					continue;
-				}
-
-				operationDependency = pendingOperation;
-
-				break;
-			}
 		}
 
 		[pendingOperations addObject:operation];
 	}
 
-	/* Add dependency to operation */
-	if (operationDependency) {
-		[operation addDependency:operationDependency];
-	}
-
 	/* Begin observing when the status of the operation changes */
 	[operation addObserver:self forKeyPath:@"isFinished" options:NSKeyValueObservingOptionNew context:nil];
 
@@ -206,26 +578,6 @@ NS_ASSUME_NONNULL_BEGIN
 		[pendingOperations removeObjectIdenticalTo:operation];
 	}
 
-	/* Remove dependency to operation */
-	/* Having a ton of chained dependencies can cause a stack overflow
-	 when they deallocate. Manually removing dependencies fixes this pattern:
-
-	 0   CoreFoundation                       0x00007fffa2694d1e -[__NSArrayM dealloc] + 14
-	 1   Foundation                           0x00007fffa410d79b -[__NSOperationInternal dealloc] + 177
-	 2   Foundation                           0x00007fffa410d664 -[NSOperation dealloc] + 58
-	 3   CoreFoundation                       0x00007fffa27e237e common_removeAllObjects + 254
-	 4   CoreFoundation                       0x00007fffa2694d23 -[__NSArrayM dealloc] + 19
-	 5   Foundation                           0x00007fffa410d79b -[__NSOperationInternal dealloc] + 177
-	 6   Foundation                           0x00007fffa410d664 -[NSOperation dealloc] + 58
-	 7   CoreFoundation                       0x00007fffa27e237e common_removeAllObjects + 254
-
-	 ... repeated for a total of 512 hops before crashing. */
-	NSOperation *operationDependency = operation.dependencies.firstObject;
-
-	if (operationDependency) {
-		[operation removeDependency:operationDependency];
-	}
-
 	/* End observing when the status of the operation changes */
 	[operation removeObserver:self forKeyPath:@"isFinished"];
 }
@@ -240,6 +592,8 @@ NS_ASSUME_NONNULL_BEGIN
 	NSArray *operations = [self pendingOperationsForViewController:viewController];
 
 	[operations makeObjectsPerformSelector:@selector(cancel)];
+
+	[self cancelOperationsInLaneForViewController:viewController];
 }
 
 - (void)cancelOperationsForClient:(IRCClient *)client
@@ -266,13 +620,15 @@ NS_ASSUME_NONNULL_BEGIN
 	NSArray *operations = [self pendingOperationsForViewController:viewController];
 
 	for (TVCLogControllerPrintingOperation *operation in operations) {
-		if (operation.isPending == NO || operation.dependencies.count > 0) {
+		if (operation.isPending == NO) {
 			continue;
 		}
 
 		[operation willChangeValueForKey:@"isReady"];
 		[operation didChangeValueForKey:@"isReady"];
 	}
+
+	[self scheduleLaneForViewController:viewController];
 }
 
 - (void)observeValueForKeyPath:(nullable NSString *)keyPath ofObject:(nullable id)object change:(nullable NSDictionary<NSString *, id> *)change context:(nullable void *)context
@@ -287,6 +643,9 @@ NS_ASSUME_NONNULL_BEGIN
 #pragma mark -
 #pragma mark Operation Queue Items
 
+@implementation TVCLogControllerPrintingLane
+@end
+
 @implementation TVCLogControllerPrintingOperation
 
 - (BOOL)isPending
@@ -310,11 +669,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)isReady
 {
-	if (self.dependencies.count < 1 || self.isStandalone) {
-		return (super.isReady && self.viewController.viewIsLoaded);
-	} else {
-		return  super.isReady;
-	}
+	return (super.isReady && self.viewController.viewIsLoaded);
 }
 
 @end
@@ -71,6 +71,14 @@ NS_ASSUME_NONNULL_BEGIN
 #define _enqueueBlockStandalone(operationBlock)			\
 	[self.printingQueue enqueueMessageBlock:(operationBlock) for:self isStandalone:YES];
 
+/* Lines appended to the document are held on to for this long so that
+ all lines printed within a display refresh are appended in one call. */
+#define _pendingAppendsFlushInterval			(1.0 / 60.0)
+
+/* The number of lines printed while a view is hidden that are kept
+ to be rendered once it becomes visible. About one screenful. */
+#define _deferredLogLinesLimit			100
+
 @interface TVCLogControllerPrintOperationContext ()
 @property (nonatomic, weak, readwrite) IRCClient *client;
 @property (nonatomic, weak, readwrite) IRCChannel *channel;
@@ -92,6 +100,16 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, copy, nullable, readwrite) NSString *oldestLineNumber;
 @property (nonatomic, copy, nullable, readwrite) NSString *newestLineNumber;
 @property (nonatomic, strong, nullable) TVCLogLine *lastLine;
+@property (nonatomic, assign) NSUInteger printTransactionDepth;
+@property (nonatomic, strong, nullable) NSMutableArray<TVCLogLine *> *printTransactionLogLines;
+@property (nonatomic, strong, nullable) NSMutableArray *printTransactionCompletionBlocks;
+@property (nonatomic, strong) NSMutableString *pendingAppendsHTML;
+@property (nonatomic, strong) NSMutableArray<NSString *> *pendingAppendsLineNumbers;
+@property (nonatomic, assign) BOOL pendingAppendsFlushScheduled;
+@property (nonatomic, assign) BOOL renderingDeferralRequested;
+@property (nonatomic, assign) BOOL renderingDeferred;
+@property (nonatomic, strong) NSMutableArray<TVCLogLine *> *deferredLogLines;
+@property (nonatomic, assign) BOOL deferredLogLinesOverflowed;
 @property (nonatomic, strong) NSMutableArray<NSString *> *highlightedLineNumbers;
 @property (nonatomic, strong) NSCache *jumpToLineCallbacks;
 @property (nonatomic, strong, readwrite) TVCLogView *backingView;
@@ -167,6 +185,12 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 
 	self.highlightedLineNumbers	= [NSMutableArray new];
 
+	self.pendingAppendsHTML = [NSMutableString string];
+
+	self.pendingAppendsLineNumbers = [NSMutableArray array];
+
+	self.deferredLogLines = [NSMutableArray array];
+
 	self.jumpToLineCallbacks = [NSCache new];
 }
 
@@ -176,6 +200,8 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 
 	self.loaded = NO;
 
+	[self discardPendingAppends];
+
 	[self.backingView stopLoading]; // allow view to teardown
 	self.backingView = nil;
 
@@ -373,14 +399,91 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 		return;
 	}
 
+	/* Anything evaluated may depend on lines appended before it */
+	[self flushPendingAppends];
+
 	[self.backingView evaluateFunction:function withArguments:arguments];
 }
 
+/* Appending a line to the WebView has the WebView mutate the document,
+ enforce the scrollback limit, scroll, and notify us of the new line.
+ Busy channels print many lines within the same display refresh.
+ Lines are therefore held on to and appended as one fragment with
+ a list of line numbers, once for each display refresh. */
+/* Any function evaluated after an append flushes pending appends before
+ it so that the order in which the WebView sees them never changes. */
 - (void)appendToDocumentBody:(NSString *)html withLineNumbers:(NSArray<NSString *> *)lineNumbers
 {
 	NSParameterAssert(html != nil);
+	NSParameterAssert(lineNumbers != nil);
+
+	if (self.loaded == NO || self.terminating) {
+		return;
+	}
+
+	BOOL scheduleFlush = NO;
+
+	@synchronized (self.pendingAppendsLineNumbers) {
+		[self.pendingAppendsHTML appendString:html];
+
+		[self.pendingAppendsLineNumbers addObjectsFromArray:lineNumbers];
+
+		if (self.pendingAppendsFlushScheduled == NO) {
+			self.pendingAppendsFlushScheduled = YES;
+
+			scheduleFlush = YES;
+		}
+	}
+
+	if (scheduleFlush == NO) {
+		return;
+	}
+
+	__weak TVCLogController *weakSelf = self;
+
+	dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(_pendingAppendsFlushInterval * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+		[weakSelf flushPendingAppends];
+	});
+}
+
+- (void)flushPendingAppends
+{
+	@synchronized (self.pendingAppendsLineNumbers) {
+		self.pendingAppendsFlushScheduled = NO;
+
+		NSMutableArray *lineNumbers = self.pendingAppendsLineNumbers;
+
+		if (lineNumbers.count == 0) {
+			return;
+		}
+
+		NSString *html = [self.pendingAppendsHTML copy];
+
+		NSArray *lineNumbersCopy = [lineNumbers copy];
 
-	[self _evaluateFunction:@"MessageBuffer.bufferElementAppend" withArguments:@[html, lineNumbers]];
+		[self.pendingAppendsHTML setString:@""];
+
+		[lineNumbers removeAllObjects];
+
+		if (self.loaded == NO || self.terminating) {
+			return;
+		}
+
+		/* The WebView evaluates functions in the order they are
+		 handed to it which is why this is done within the lock. */
+		[self.backingView evaluateFunction:@"MessageBuffer.bufferElementAppend" withArguments:@[html, lineNumbersCopy]];
+	}
+
+	[self.backingView redrawViewIfNeeded];
+}
+
+- (void)discardPendingAppends
+{
+	@synchronized (self.pendingAppendsLineNumbers) {
+		[self.pendingAppendsHTML setString:@""];
+
+		[self.pendingAppendsLineNumbers removeAllObjects];
+	}
 }
 
 #pragma mark -
@@ -718,6 +821,8 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 		[self.jumpToLineCallbacks setObject:completionHandler forKey:lineNumber];
 	}
 
+	[self flushPendingAppends];
+
 	[self.backingView evaluateFunction:@"Textual.jumpToLine" withArguments:@[lineNumber]];
 }
 
@@ -725,6 +830,8 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 {
 	[self _evaluateFunction:@"_Textual.notifyDidBecomeVisible" withArguments:nil];
 
+	[self endDeferringRendering];
+
 	[self maybeReloadHistory];
 
 	[self.backingView restoreScrollerPosition];
@@ -743,6 +850,8 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 {
 	[self _evaluateFunction:@"_Textual.notifyDidBecomeHidden" withArguments:nil];
 
+	[self beginDeferringRendering];
+
 	[self.backingView saveScrollerPosition];
 
 	[self.backingView disableOffScreenUpdates];
@@ -1007,6 +1116,10 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 
 	self.loaded = NO;
 
+	[self discardPendingAppends];
+
+	[self discardDeferredLogLines];
+
 	self.reloadingHistory = NO;
 
 	self.historyLoaded = NO;
@@ -1189,6 +1302,182 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 	completionBlock([renderedLogLines copy]);
 }
 
+#pragma mark -
+#pragma mark Deferred Rendering
+
+/* Lines printed to a view which is not visible are not rendered to HTML
+ nor appended to the WebView. They are only matched for highlights and
+ conversation tracking so that notifications and unread counts do not
+ change. The most recent lines are kept and rendered once the view
+ becomes visible. If more lines than that were printed, the buffer is
+ replaced by them and older lines are loaded from the historic log
+ as the user scrolls upward. */
+/* Deferral begins and ends through the printing queue so that every
+ line printed before the view became visible is rendered in order,
+ before any line printed after it. */
+/* Lines are never deferred for encrypted views because they are not
+ written to the historic log and could not be loaded again. */
+- (void)beginDeferringRendering
+{
+	if (self.renderingDeferralRequested || self.encrypted || self.terminating) {
+		return;
+	}
+
+	if ([RZUserDefaults() boolForKey:@"Optimizations -> Render Hidden Views Lazily"] == NO) {
+		return;
+	}
+
+	@synchronized (self.deferredLogLines) {
+		self.renderingDeferralRequested = YES;
+	}
+
+	TVCLogControllerPrintingBlock operationBlock = ^(id operation) {
+		/* The view may have been cleared or become visible
+		 again between this being enqueued and performed. */
+		@synchronized (self.deferredLogLines) {
+			self.renderingDeferred = self.renderingDeferralRequested;
+		}
+	};
+
+	_enqueueBlock(operationBlock)
+}
+
+- (void)endDeferringRendering
+{
+	if (self.renderingDeferralRequested == NO || self.terminating) {
+		return;
+	}
+
+	@synchronized (self.deferredLogLines) {
+		self.renderingDeferralRequested = NO;
+	}
+
+	TVCLogControllerPrintingBlock operationBlock = ^(id operation) {
+		NSArray<TVCLogLine *> *logLines = nil;
+
+		BOOL replaceBuffer = NO;
+
+		@synchronized (self.deferredLogLines) {
+			self.renderingDeferred = NO;
+
+			logLines = [self.deferredLogLines copy];
+
+			replaceBuffer = self.deferredLogLinesOverflowed;
+
+			[self.deferredLogLines removeAllObjects];
+
+			self.deferredLogLinesOverflowed = NO;
+		}
+
+		[self renderDeferredLogLines:logLines replacingBuffer:replaceBuffer];
+	};
+
+	_enqueueBlock(operationBlock)
+}
+
+- (void)discardDeferredLogLines
+{
+	@synchronized (self.deferredLogLines) {
+		self.renderingDeferralRequested = NO;
+
+		self.renderingDeferred = NO;
+
+		[self.deferredLogLines removeAllObjects];
+
+		self.deferredLogLinesOverflowed = NO;
+	}
+}
+
+/* Returns YES if rendering the lines is deferred in which case they are kept */
+- (BOOL)deferLogLinesIfNeeded:(NSArray<TVCLogLine *> *)logLines
+{
+	NSParameterAssert(logLines != nil);
+
+	@synchronized (self.deferredLogLines) {
+		if (self.renderingDeferred == NO) {
+			return NO;
+		}
+
+		NSMutableArray *deferredLogLines = self.deferredLogLines;
+
+		[deferredLogLines addObjectsFromArray:logLines];
+
+		if (deferredLogLines.count > _deferredLogLinesLimit) {
+			[deferredLogLines removeObjectsInRange:NSMakeRange(0, (deferredLogLines.count - _deferredLogLinesLimit))];
+
+			self.deferredLogLinesOverflowed = YES;
+		}
+
+		return YES;
+	}
+}
+
+- (void)renderDeferredLogLines:(NSArray<TVCLogLine *> *)logLines replacingBuffer:(BOOL)replaceBuffer
+{
+	NSParameterAssert(logLines != nil);
+
+	if (logLines.count == 0) {
+		return;
+	}
+
+	NSMutableArray<NSString *> *lineNumbers = [NSMutableArray arrayWithCapacity:logLines.count];
+
+	NSMutableArray<NSDictionary *> *resultInfos = [NSMutableArray arrayWithCapacity:logLines.count];
+
+	NSMutableString *htmlCombined = [NSMutableString string];
+
+	for (TVCLogLine *logLine in logLines) {
+		NSDictionary<NSString *, id> *resultInfo = nil;
+
+		NSString *html = [self renderLogLine:logLine resultInfo:&resultInfo];
+
+		if (html == nil) {
+			LogToConsoleError("Failed to render log line %@", logLine.description);
+
+			continue;
+		}
+
+		[htmlCombined appendString:html];
+
+		[lineNumbers addObject:logLine.uniqueIdentifier];
+
+		[resultInfos addObject:((resultInfo) ?: @{})];
+	}
+
+	if (lineNumbers.count == 0) {
+		return;
+	}
+
+	XRPerformBlockAsynchronouslyOnMainQueue(^{
+		if (self.terminating) {
+			return;
+		}
+
+		if (replaceBuffer) {
+			[self _evaluateFunction:@"_MessageBuffer.bufferElementReplace" withArguments:@[htmlCombined, lineNumbers]];
+		} else {
+			[self appendToDocumentBody:htmlCombined withLineNumbers:lineNumbers];
+		}
+
+		/* Highlights, conversation tracking, and completion blocks were
+		 taken care of when the lines were printed. What is left are
+		 the things that depend on the line being in the WebView. */
+		[resultInfos enumerateObjectsUsingBlock:^(NSDictionary<NSString *, id> *resultInfo, NSUInteger index, BOOL *stop) {
+			THOPluginDidPostNewMessageConcreteObject *pluginObject = resultInfo[@"pluginConcreteObject"];
+
+			if (pluginObject) {
+				[THOPluginDispatcher enqueueDidPostNewMessage:pluginObject];
+			}
+
+			if ([resultInfo boolForKey:@"processInlineMedia"]) {
+				NSArray<AHHyperlinkScannerResult *> *listOfLinks = resultInfo[TVCLogRendererResultsListOfLinksInBodyAttribute];
+
+				[self processInlineMedia:listOfLinks atLineNumber:lineNumbers[index]];
+			}
+		}];
+	});
+}
+
 #pragma mark -
 #pragma mark Print
 
@@ -1211,67 +1500,133 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 
 	self.lastLine = logLine;
 
+	id completionBlockObject = ((completionBlock) ?: [NSNull null]);
+
+	if (self.printTransactionDepth > 0) {
+		[self.printTransactionLogLines addObject:logLine];
+
+		[self.printTransactionCompletionBlocks addObject:completionBlockObject];
+
+		return;
+	}
+
+	[self printLogLines:@[logLine] completionBlocks:@[completionBlockObject]];
+}
+
+/* A print transaction holds on to lines printed until it ends at which
+ point they are rendered as one fragment, appended to the WebView in
+ one call, and written to the historic log in one call. This is used
+ when a large number of lines are printed at the same time such as
+ when the messages in a BATCH are processed. */
+- (void)beginPrintTransaction
+{
+	if (self.printTransactionDepth == 0) {
+		self.printTransactionLogLines = [NSMutableArray array];
+
+		self.printTransactionCompletionBlocks = [NSMutableArray array];
+	}
+
+	self.printTransactionDepth += 1;
+}
+
+- (void)endPrintTransaction
+{
+	if (self.printTransactionDepth == 0) {
+		return;
+	}
+
+	self.printTransactionDepth -= 1;
+
+	if (self.printTransactionDepth > 0) {
+		return;
+	}
+
+	NSArray *logLines = [self.printTransactionLogLines copy];
+
+	NSArray *completionBlocks = [self.printTransactionCompletionBlocks copy];
+
+	self.printTransactionLogLines = nil;
+
+	self.printTransactionCompletionBlocks = nil;
+
+	if (logLines.count == 0 || self.terminating) {
+		return;
+	}
+
+	[self printLogLines:logLines completionBlocks:completionBlocks];
+}
+
+/* Each entry in completionBlocks is a completion block or NSNull */
+- (void)printLogLines:(NSArray<TVCLogLine *> *)logLines completionBlocks:(NSArray *)completionBlocks
+{
+	NSParameterAssert(logLines != nil);
+	NSParameterAssert(completionBlocks != nil);
+	NSParameterAssert(logLines.count == completionBlocks.count);
+
 	TVCLogControllerPrintingBlock printBlock = ^(id operation) {
-		NSDictionary<NSString *, id> *resultInfo = nil;
+		NSUInteger logLineCount = logLines.count;
 
-		NSString *html = [self renderLogLine:logLine resultInfo:&resultInfo];
+		NSMutableArray<NSString *> *lineNumbers = [NSMutableArray arrayWithCapacity:logLineCount];
 
-		if (html == nil) {
-			LogToConsoleError("Failed to render log line %@", logLine.description);
+		NSMutableArray<NSDictionary *> *resultInfos = [NSMutableArray arrayWithCapacity:logLineCount];
 
-			return;
-		}
+		NSMutableIndexSet *renderedIndexes = [NSMutableIndexSet indexSet];
 
-		NSString *lineNumber = logLine.uniqueIdentifier;
+		NSMutableString *htmlCombined = [NSMutableString string];
 
-		NSSet<IRCChannelUser *> *listOfUsers = resultInfo[TVCLogRendererResultsListOfUsersFoundAttribute];
+		BOOL renderingDeferred = [self deferLogLinesIfNeeded:logLines];
 
-		BOOL processInlineMedia = [resultInfo boolForKey:@"processInlineMedia"];
+		[logLines enumerateObjectsUsingBlock:^(TVCLogLine *logLine, NSUInteger index, BOOL *stop) {
+			NSDictionary<NSString *, id> *resultInfo = nil;
 
-		BOOL highlighted = [resultInfo boolForKey:TVCLogRendererResultsKeywordMatchFoundAttribute];
+			if (renderingDeferred) {
+				resultInfo = [self matchLogLine:logLine];
+			} else {
+				NSString *html = [self renderLogLine:logLine resultInfo:&resultInfo];
 
-		THOPluginDidPostNewMessageConcreteObject *pluginObject = resultInfo[@"pluginConcreteObject"];
+				if (html == nil) {
+					LogToConsoleError("Failed to render log line %@", logLine.description);
 
-		XRPerformBlockAsynchronouslyOnMainQueue(^{
-			if (self.terminating) {
-				return;
-			}
+					return;
+				}
 
-			if (self.oldestLineNumber == nil) {
-				self.oldestLineNumber = lineNumber;
+				[htmlCombined appendString:html];
 			}
 
-			self.newestLineNumber = lineNumber;
+			[lineNumbers addObject:logLine.uniqueIdentifier];
 
-			IRCClient *client = self.associatedClient;
-			IRCChannel *channel = self.associatedChannel;
+			[resultInfos addObject:((resultInfo) ?: @{})];
 
-			if (highlighted) {
-				@synchronized(self.highlightedLineNumbers) {
-					[self.highlightedLineNumbers addObject:lineNumber];
-				}
+			[renderedIndexes addIndex:index];
+		}];
+
+		if (renderedIndexes.count == 0) {
+			return;
+		}
 
-				[client cacheHighlightInChannel:channel withLogLine:logLine];
+		NSArray<TVCLogLine *> *renderedLogLines = [logLines objectsAtIndexes:renderedIndexes];
+
+		NSArray *renderedCompletionBlocks = [completionBlocks objectsAtIndexes:renderedIndexes];
+
+		XRPerformBlockAsynchronouslyOnMainQueue(^{
+			if (self.terminating) {
+				return;
 			}
 
-			if (pluginObject) {
-				[THOPluginDispatcher enqueueDidPostNewMessage:resultInfo[@"pluginConcreteObject"]];
+			if (self.oldestLineNumber == nil) {
+				self.oldestLineNumber = lineNumbers.firstObject;
 			}
 
-			[self appendToDocumentBody:html withLineNumbers:@[lineNumber]];
+			self.newestLineNumber = lineNumbers.lastObject;
 
-#warning TODO: Modify logic of inline media to only truly \
-	process images if the line is in fact on the WebView.
-			/* Begin processing inline media */
-			/* We go through the inline media list here and pass to the loader now so
-			 that we know the links have hit the WebView before we even try loading them. */
-			if (processInlineMedia) {
-				NSArray<AHHyperlinkScannerResult *> *listOfLinks = resultInfo[TVCLogRendererResultsListOfLinksInBodyAttribute];
+			IRCClient *client = self.associatedClient;
+			IRCChannel *channel = self.associatedChannel;
 
-				[self processInlineMedia:listOfLinks atLineNumber:lineNumber];
+			if (renderingDeferred == NO) {
+				[self appendToDocumentBody:htmlCombined withLineNumbers:lineNumbers];
 			}
 
-			/* Log this log line */
+			/* Log these log lines */
 			/* If the channel is encrypted, then we refuse to write to
 			 the actual historic log so there is no trace of the chatter
 			 on the disk in the form of an unencrypted cache file. */
@@ -1279,51 +1634,85 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 			 in the view as well as playback on restart, but the added
 			 security can be seen as a bonus. */
 			if (self.encrypted == NO) {
-				[TVCLogControllerHistoricLogSharedInstance() writeNewEntryWithLogLine:logLine forItem:self.associatedItem];
+				if (renderedLogLines.count == 1) {
+					[TVCLogControllerHistoricLogSharedInstance() writeNewEntryWithLogLine:renderedLogLines[0] forItem:self.associatedItem];
+				} else {
+					[TVCLogControllerHistoricLogSharedInstance() writeNewEntriesWithLogLines:renderedLogLines forItem:self.associatedItem];
+				}
 			}
 
-			/* Redraw view if needed */
-			[self.backingView redrawViewIfNeeded];
+			[renderedLogLines enumerateObjectsUsingBlock:^(TVCLogLine *logLine, NSUInteger index, BOOL *stop) {
+				NSString *lineNumber = lineNumbers[index];
 
-			/* Using information provided by conversation tracking we can update 
-			 our internal array of favored nicknames for nick completion. */
-			if (logLine.memberType == TVCLogLineMemberTypeLocalUser) {
-				[listOfUsers.allObjects makeObjectsPerformSelector:@selector(outgoingConversation)];
-			} else {
-				[listOfUsers.allObjects makeObjectsPerformSelector:@selector(conversation)];
-			}
+				NSDictionary<NSString *, id> *resultInfo = resultInfos[index];
 
-			if (completionBlock == nil) {
-				return;
-			}
+				NSSet<IRCChannelUser *> *listOfUsers = resultInfo[TVCLogRendererResultsListOfUsersFoundAttribute];
 
-			 TVCLogControllerPrintOperationContext *contextObject =
-			[TVCLogControllerPrintOperationContext new];
+				BOOL processInlineMedia = [resultInfo boolForKey:@"processInlineMedia"];
 
-			contextObject.client = client;
-			contextObject.channel = channel;
-			contextObject.highlight = highlighted;
-			contextObject.logLine = logLine;
-			contextObject.lineNumber = lineNumber;
+				BOOL highlighted = [resultInfo boolForKey:TVCLogRendererResultsKeywordMatchFoundAttribute];
+
+				THOPluginDidPostNewMessageConcreteObject *pluginObject = resultInfo[@"pluginConcreteObject"];
+
+				if (highlighted) {
+					@synchronized(self.highlightedLineNumbers) {
+						[self.highlightedLineNumbers addObject:lineNumber];
+					}
+
+					[client cacheHighlightInChannel:channel withLogLine:logLine];
+				}
 
-			completionBlock(contextObject);
+				if (pluginObject) {
+					[THOPluginDispatcher enqueueDidPostNewMessage:pluginObject];
+				}
+
+#warning TODO: Modify logic of inline media to only truly \
+	process images if the line is in fact on the WebView.
+				/* Begin processing inline media */
+				/* We go through the inline media list here and pass to the loader now so
+				 that we know the links have hit the WebView before we even try loading them. */
+				if (processInlineMedia) {
+					NSArray<AHHyperlinkScannerResult *> *listOfLinks = resultInfo[TVCLogRendererResultsListOfLinksInBodyAttribute];
+
+					[self processInlineMedia:listOfLinks atLineNumber:lineNumber];
+				}
+
+				/* Using information provided by conversation tracking we can update
+				 our internal array of favored nicknames for nick completion. */
+				if (logLine.memberType == TVCLogLineMemberTypeLocalUser) {
+					[listOfUsers.allObjects makeObjectsPerformSelector:@selector(outgoingConversation)];
+				} else {
+					[listOfUsers.allObjects makeObjectsPerformSelector:@selector(conversation)];
+				}
+
+				TVCLogControllerPrintOperationCompletionBlock completionBlock = renderedCompletionBlocks[index];
+
+				if ((id)completionBlock == [NSNull null]) {
+					return;
+				}
+
+				 TVCLogControllerPrintOperationContext *contextObject =
+				[TVCLogControllerPrintOperationContext new];
+
+				contextObject.client = client;
+				contextObject.channel = channel;
+				contextObject.highlight = highlighted;
+				contextObject.logLine = logLine;
+				contextObject.lineNumber = lineNumber;
+
+				completionBlock(contextObject);
+			}];
 		});
 	};
 
 	_enqueueBlock(printBlock)
 }
 
-- (nullable NSString *)renderLogLine:(TVCLogLine *)logLine resultInfo:(NSDictionary<NSString *, id> ** _Nullable)resultInfo
+- (NSDictionary<NSString *, id> *)rendererAttributesForLogLine:(TVCLogLine *)logLine
 {
 	NSParameterAssert(logLine != nil);
 
-	// ************************************************************************** /
-
-	TVCLogLineType lineType = logLine.lineType;
-
-	NSString *lineTypeString = logLine.lineTypeString;
-
-	BOOL renderLinks = ([[TLOLinkParser bannedLineTypes] containsObject:lineTypeString] == NO);
+	BOOL renderLinks = ([[TLOLinkParser bannedLineTypes] containsObject:logLine.lineTypeString] == NO);
 
 	NSMutableDictionary<NSString *, id> *rendererAttributes = [NSMutableDictionary dictionary];
 
@@ -1339,12 +1728,35 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 	[rendererAttributes setUnsignedInteger:logLine.lineType forKey:TVCLogRendererConfigurationLineTypeAttribute];
 	[rendererAttributes setUnsignedInteger:logLine.memberType forKey:TVCLogRendererConfigurationMemberTypeAttribute];
 
+	return rendererAttributes;
+}
+
+/* Returns what rendering would have found in a line without rendering it */
+- (NSDictionary<NSString *, id> *)matchLogLine:(TVCLogLine *)logLine
+{
+	NSParameterAssert(logLine != nil);
+
+	return [TVCLogRenderer matchBody:logLine.messageBody
+				   forViewController:self
+					  withAttributes:[self rendererAttributesForLogLine:logLine]];
+}
+
+- (nullable NSString *)renderLogLine:(TVCLogLine *)logLine resultInfo:(NSDictionary<NSString *, id> ** _Nullable)resultInfo
+{
+	NSParameterAssert(logLine != nil);
+
+	// ************************************************************************** /
+
+	TVCLogLineType lineType = logLine.lineType;
+
+	NSString *lineTypeString = logLine.lineTypeString;
+
 	NSDictionary<NSString *, id> *rendererResults = nil;
 
 	NSString *renderedBody =
 	[TVCLogRenderer renderBody:logLine.messageBody
 			 forViewController:self
-				withAttributes:rendererAttributes
+				withAttributes:[self rendererAttributesForLogLine:logLine]
 					resultInfo:&rendererResults];
 
 	if (renderedBody == nil) {
@@ -1694,6 +2106,10 @@ NSString * const TVCLogControllerViewFinishedLoadingNotification = @"TVCLogContr
 
 	[self reloadHistory];
 
+	if (self.visible == NO) {
+		[self beginDeferringRendering];
+	}
+
 	[RZNotificationCenter() postNotificationName:TVCLogControllerViewFinishedLoadingNotification object:self];
 
 	[self.printingQueue updateReadinessState:self];
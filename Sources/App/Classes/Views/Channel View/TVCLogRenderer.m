@@ -42,6 +42,8 @@
 #import "IRCClientConfig.h"
 #import "IRCClient.h"
 #import "IRCChannel.h"
+#import "IRCChannelMemberListPrivate.h"
+#import "IRCChannelNicknameScannerPrivate.h"
 #import "IRCChannelUser.h"
 #import "IRCColorFormat.h"
 #import "IRCUser.h"
@@ -55,6 +57,7 @@
 #import "TVCLogController.h"
 #import "TVCLogLine.h"
 #import "TVCLogRenderer.h"
+#import "TVCLogRendererKeywordMatcherPrivate.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -346,115 +349,34 @@ NSString * const TVCLogRendererResultsOriginalBodyWithoutEffectsAttribute = @"TV
 		return;
 	}
 
-	NSMutableArray<NSValue *> *excludeRanges = [NSMutableArray array];
+	TVCLogRendererKeywordMatcher *matcher =
+	[TVCLogRendererKeywordMatcher matcherForHighlightKeywords:highlightKeywords
+											 excludedKeywords:excludedKeywords
+											   matchingMethod:[TPCPreferences highlightMatchingMethod]];
 
-	for (NSString *excludeKeyword in excludedKeywords) {
-		[self->_body enumerateMatchesOfString:excludeKeyword withBlock:^(NSRange range, BOOL *stop) {
-			[excludeRanges addObject:[NSValue valueWithRange:range]];
-		} options:NSCaseInsensitiveSearch];
-	}
-
-	BOOL foundKeyword = NO;
-
-	switch ([TPCPreferences highlightMatchingMethod]) {
-		case TXNicknameHighlightMatchTypeExact:
-		case TXNicknameHighlightMatchTypePartial:
-		{
-			foundKeyword = [self matchKeywordsUsingNormalMatching:highlightKeywords excludedRanges:excludeRanges];
-
-			break;
-		}
-		case TXNicknameHighlightMatchTypeRegularExpression:
-		{
-			foundKeyword = [self matchKeywordsUsingRegularExpression:highlightKeywords excludedRanges:excludeRanges];
-
-			break;
-		}
-	}
-
-	self->_outputDictionary[TVCLogRendererResultsKeywordMatchFoundAttribute] = @(foundKeyword);
-}
-
-- (BOOL)matchKeywordsUsingNormalMatching:(NSArray<NSString *> *)keywords excludedRanges:(NSArray<NSValue *> *)excludedRanges
-{
-	NSParameterAssert(keywords != nil);
-	NSParameterAssert(excludedRanges != nil);
-
-	NSString *body = self->_body;
+	BOOL exactMatch = (matcher.matchingMethod == TXNicknameHighlightMatchTypeExact);
 
 	__block BOOL foundKeyword = NO;
 
-	for (NSString *keyword in keywords) {
-		[body enumerateMatchesOfString:keyword withBlock:^(NSRange range, BOOL *stop) {
-			for (NSValue *excludedRange in excludedRanges) {
-				if (NSIntersectionRange(range, excludedRange.rangeValue).length > 0) {
-					return;
-				}
-			}
-
-			if ([TPCPreferences highlightMatchingMethod] == TXNicknameHighlightMatchTypeExact) {
-				if ([self sectionOfBodyIsSurroundedByNonAlphabeticals:range] == NO) {
-					return;
-				}
-			}
-
-			if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingURLAttribute inRange:range] == NO) {
-				[self->_bodyWithAttributes addAttribute:TVCLogRendererFormattingKeywordHighlightAttribute value:@(YES) range:range];
-
-				foundKeyword = YES;
-
-				*stop = YES;
-			}
-		} options:NSCaseInsensitiveSearch];
-
-		if (foundKeyword) {
-			break;
-		}
-	}
-
-	return foundKeyword;
-}
-
-- (BOOL)matchKeywordsUsingRegularExpression:(NSArray<NSString *> *)keywords excludedRanges:(NSArray<NSValue *> *)excludedRanges
-{
-	NSParameterAssert(keywords != nil);
-	NSParameterAssert(excludedRanges != nil);
-
-	NSString *body = self->_body;
-
-	BOOL foundKeyword = NO;
-
-	for (NSString *keyword in keywords) {
-		NSRange range = [XRRegularExpression string:body rangeOfRegex:keyword withoutCase:YES];
-
-		if (range.location == NSNotFound) {
-			continue;
-		}
-
-		BOOL enabled = YES;
-
-		for (NSValue *excludedRange in excludedRanges) {
-			if (NSIntersectionRange(range, excludedRange.rangeValue).length > 0) {
-				enabled = NO;
-
-				break;
+	[matcher enumerateKeywordsInString:self->_body withBlock:^BOOL(NSRange range) {
+		if (exactMatch) {
+			if ([self sectionOfBodyIsSurroundedByNonAlphabeticals:range] == NO) {
+				return NO;
 			}
 		}
 
-		if (enabled == NO) {
-			continue;
+		if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingURLAttribute inRange:range]) {
+			return NO;
 		}
 
-		if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingURLAttribute inRange:range] == NO) {
-			[self->_bodyWithAttributes addAttribute:TVCLogRendererFormattingKeywordHighlightAttribute value:@(YES) range:range];
+		[self->_bodyWithAttributes addAttribute:TVCLogRendererFormattingKeywordHighlightAttribute value:@(YES) range:range];
 
-			foundKeyword = YES;
+		foundKeyword = YES;
 
-			break;
-		}
-	}
+		return YES;
+	}];
 
-	return foundKeyword;
+	self->_outputDictionary[TVCLogRendererResultsKeywordMatchFoundAttribute] = @(foundKeyword);
 }
 
 - (void)findAllChannelNames
@@ -531,33 +453,32 @@ NSString * const TVCLogRendererResultsOriginalBodyWithoutEffectsAttribute = @"TV
 
 	IRCChannel *channel = self->_viewController.associatedChannel;
 
-	NSArray<IRCChannelUser *> *users = channel.memberList;
+	IRCChannelNicknameScanner *nicknameScanner = channel.memberInfo.nicknameScanner;
 
 	__block NSUInteger totalNicknameCount = 0;
 	__block NSUInteger totalNicknameLength = 0;
 
 	NSMutableSet<IRCChannelUser *> *userSet = [NSMutableSet set];
 
-	for (IRCChannelUser *user in users) {
-		[body enumerateMatchesOfString:user.user.nickname withBlock:^(NSRange range, BOOL *stop) {
-			if ([self sectionOfBodyIsSurroundedByNonAlphabeticals:range] == NO) {
-				return;
-			}
+	/* The nickname of every member is found in one pass over the body */
+	[nicknameScanner enumerateMembersInString:body withBlock:^(IRCChannelUser *user, NSRange range) {
+		if ([self sectionOfBodyIsSurroundedByNonAlphabeticals:range] == NO) {
+			return;
+		}
 
-			if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingURLAttribute inRange:range] == NO) {
-				[self->_bodyWithAttributes addAttribute:TVCLogRendererFormattingConversationTrackingAttribute value:@(YES) range:range];
+		if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingURLAttribute inRange:range] == NO) {
+			[self->_bodyWithAttributes addAttribute:TVCLogRendererFormattingConversationTrackingAttribute value:@(YES) range:range];
 
-				if ([userSet containsObject:user] == NO) {
-					[userSet addObject:user];
-				}
+			if ([userSet containsObject:user] == NO) {
+				[userSet addObject:user];
+			}
 
-				if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingKeywordHighlightAttribute inRange:range] == NO) {
-					totalNicknameCount += 1;
-					totalNicknameLength += range.length;
-				}
+			if ([self->_bodyWithAttributes isAttributeSet:TVCLogRendererFormattingKeywordHighlightAttribute inRange:range] == NO) {
+				totalNicknameCount += 1;
+				totalNicknameLength += range.length;
 			}
-		} options:NSCaseInsensitiveSearch];
-	}
+		}
+	}];
 
 	/* Calculate how much of the message is just nicknames.
 	 This is used when trying to stop highlight spam.
@@ -996,6 +917,52 @@ NSString * const TVCLogRendererResultsOriginalBodyWithoutEffectsAttribute = @"TV
 	return renderer.finalResult;
 }
 
++ (NSDictionary<NSString *, id> *)matchBody:(NSString *)body forViewController:(TVCLogController *)viewController withAttributes:(NSDictionary<NSString *, id> *)inputDictionary
+{
+	NSParameterAssert(body != nil);
+	NSParameterAssert(viewController != nil);
+	NSParameterAssert(inputDictionary != nil);
+
+	if (body.length == 0) {
+		return @{};
+	}
+
+	TVCLogLineType lineType = [inputDictionary unsignedIntegerForKey:TVCLogRendererConfigurationLineTypeAttribute];
+
+	TVCLogLineMemberType memberType = [inputDictionary unsignedIntegerForKey:TVCLogRendererConfigurationMemberTypeAttribute];
+
+	TVCLogRenderer *renderer = [self new];
+
+	/* Plugins are not asked to modify the body here. They are asked
+	 when the line is rendered so that they are only asked once. */
+	renderer.body = body;
+
+	renderer.lineType = lineType;
+
+	renderer.memberType = memberType;
+
+	renderer.rendererAttributes = inputDictionary;
+
+	renderer.viewController = viewController;
+
+	[renderer stripDangerousUnicodeCharactersFromBody];
+
+	[renderer buildEffectsDictionary];
+
+	/* Links are found because a keyword inside of a link is not a match */
+	[renderer buildListOfLinksInBody];
+
+	[renderer matchKeywords];
+
+	[renderer scanBodyForChannelMembers];
+
+	NSDictionary *outputDictionary = [renderer.outputDictionary copy];
+
+	[renderer cleanupResources];
+
+	return outputDictionary;
+}
+
 + (NSAttributedString *)renderBodyAsAttributedString:(NSString *)body withAttributes:(NSDictionary<NSString *, id> *)inputDictionary
 {
 	NSParameterAssert(body != nil);
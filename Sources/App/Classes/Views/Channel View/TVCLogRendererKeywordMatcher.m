@@ -0,0 +1,434 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "TLOStringAutomatonPrivate.h"
+#import "TVCLogRendererKeywordMatcherPrivate.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/* The number of keyword lists that are kept compiled. Highlight keywords
+ include the local user's nickname, which means there is usually one list
+ for each connected client. A list that changes is compiled again and
+ the list it replaced is eventually evicted from the cache. */
+#define _cachedMatchersLimit		32
+
+@interface TVCLogRendererKeywordMatcherCacheKey : NSObject
+@property (nonatomic, assign) TXNicknameHighlightMatchType matchingMethod;
+@property (nonatomic, copy) NSArray<NSString *> *highlightKeywords;
+@property (nonatomic, copy) NSArray<NSString *> *excludedKeywords;
+@property (nonatomic, assign) NSUInteger keyHash;
+@end
+
+@interface TVCLogRendererKeywordMatcher ()
+@property (nonatomic, assign, readwrite) TXNicknameHighlightMatchType matchingMethod;
+@property (nonatomic, copy) NSArray<NSString *> *highlightKeywords;
+@property (nonatomic, copy) NSArray<NSString *> *excludedKeywords;
+@property (nonatomic, copy, nullable) NSArray<NSRegularExpression *> *highlightExpressions;
+
+/* nil when a keyword changes length when case folded. Such keyword
+ cannot be mapped back to a range of the string that is searched
+ in which case each keyword is searched for one at a time. */
+@property (nonatomic, strong, nullable) TLOStringAutomaton *automaton;
+
+/* For each string in the automaton: the index of the first highlight
+ keyword that it is or NSNotFound, and whether it is excluded. */
+@property (nonatomic, copy, nullable) NSArray<NSNumber *> *stringKeywordIndexes;
+@property (nonatomic, copy, nullable) NSIndexSet *excludedStrings;
+@end
+
+@implementation TVCLogRendererKeywordMatcherCacheKey
+
+- (instancetype)initWithHighlightKeywords:(NSArray<NSString *> *)highlightKeywords excludedKeywords:(NSArray<NSString *> *)excludedKeywords matchingMethod:(TXNicknameHighlightMatchType)matchingMethod
+{
+	NSParameterAssert(highlightKeywords != nil);
+	NSParameterAssert(excludedKeywords != nil);
+
+	if ((self = [super init])) {
+		self.matchingMethod = matchingMethod;
+
+		self.highlightKeywords = highlightKeywords;
+
+		self.excludedKeywords = excludedKeywords;
+
+		/* -[NSArray hash] is the number of objects in the array
+		 which is not enough to tell keyword lists apart. */
+		NSUInteger keyHash = matchingMethod;
+
+		for (NSString *keyword in highlightKeywords) {
+			keyHash = ((keyHash * 31) ^ keyword.hash);
+		}
+
+		for (NSString *keyword in excludedKeywords) {
+			keyHash = ((keyHash * 37) ^ keyword.hash);
+		}
+
+		self.keyHash = keyHash;
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (NSUInteger)hash
+{
+	return self.keyHash;
+}
+
+- (BOOL)isEqual:(id)object
+{
+	if (object == self) {
+		return YES;
+	}
+
+	if ([object isKindOfClass:[TVCLogRendererKeywordMatcherCacheKey class]] == NO) {
+		return NO;
+	}
+
+	TVCLogRendererKeywordMatcherCacheKey *objectCast = (TVCLogRendererKeywordMatcherCacheKey *)object;
+
+	return (self.keyHash == objectCast.keyHash &&
+			self.matchingMethod == objectCast.matchingMethod &&
+			[self.highlightKeywords isEqualToArray:objectCast.highlightKeywords] &&
+			[self.excludedKeywords isEqualToArray:objectCast.excludedKeywords]);
+}
+
+@end
+
+@implementation TVCLogRendererKeywordMatcher
+
++ (NSCache<TVCLogRendererKeywordMatcherCacheKey *, TVCLogRendererKeywordMatcher *> *)cachedMatchers
+{
+	static NSCache *cachedMatchers = nil;
+
+	static dispatch_once_t onceToken;
+
+	dispatch_once(&onceToken, ^{
+		cachedMatchers = [NSCache new];
+
+		cachedMatchers.countLimit = _cachedMatchersLimit;
+	});
+
+	return cachedMatchers;
+}
+
++ (instancetype)matcherForHighlightKeywords:(NSArray<NSString *> *)highlightKeywords excludedKeywords:(nullable NSArray<NSString *> *)excludedKeywords matchingMethod:(TXNicknameHighlightMatchType)matchingMethod
+{
+	NSParameterAssert(highlightKeywords != nil);
+
+	if (excludedKeywords == nil) {
+		excludedKeywords = @[];
+	}
+
+	TVCLogRendererKeywordMatcherCacheKey *cacheKey =
+	[[TVCLogRendererKeywordMatcherCacheKey alloc] initWithHighlightKeywords:highlightKeywords
+														   excludedKeywords:excludedKeywords
+															 matchingMethod:matchingMethod];
+
+	NSCache *cachedMatchers = [self cachedMatchers];
+
+	TVCLogRendererKeywordMatcher *matcher = [cachedMatchers objectForKey:cacheKey];
+
+	if (matcher == nil) {
+		matcher = [[self alloc] initWithHighlightKeywords:cacheKey.highlightKeywords
+										 excludedKeywords:cacheKey.excludedKeywords
+										   matchingMethod:matchingMethod];
+
+		[cachedMatchers setObject:matcher forKey:cacheKey];
+	}
+
+	return matcher;
+}
+
+- (instancetype)init
+{
+	[self doesNotRecognizeSelector:_cmd];
+
+	return nil;
+}
+
+- (instancetype)initWithHighlightKeywords:(NSArray<NSString *> *)highlightKeywords excludedKeywords:(NSArray<NSString *> *)excludedKeywords matchingMethod:(TXNicknameHighlightMatchType)matchingMethod
+{
+	NSParameterAssert(highlightKeywords != nil);
+	NSParameterAssert(excludedKeywords != nil);
+
+	if ((self = [super init])) {
+		self.matchingMethod = matchingMethod;
+
+		self.highlightKeywords = highlightKeywords;
+
+		self.excludedKeywords = excludedKeywords;
+
+		[self compile];
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (void)compile
+{
+	TXNicknameHighlightMatchType matchingMethod = self.matchingMethod;
+
+	/* Excluded keywords are matched literally no matter the matching method */
+	TLOStringAutomaton *automaton = [TLOStringAutomaton new];
+
+	NSMutableArray<NSNumber *> *stringKeywordIndexes = [NSMutableArray array];
+
+	NSMutableIndexSet *excludedStrings = [NSMutableIndexSet indexSet];
+
+	BOOL (^addKeyword)(NSString *, NSUInteger, BOOL) = ^BOOL (NSString *keyword, NSUInteger keywordIndex, BOOL excluded) {
+		NSUInteger keywordLength = keyword.length;
+
+		if (keywordLength == 0) {
+			return YES;
+		}
+
+		NSString *foldedKeyword = [keyword stringByFoldingWithOptions:NSCaseInsensitiveSearch locale:nil];
+
+		if (foldedKeyword.length != keywordLength) {
+			return NO;
+		}
+
+		NSUInteger stringIndex = [automaton addString:foldedKeyword];
+
+		if (stringIndex == stringKeywordIndexes.count) {
+			[stringKeywordIndexes addObject:@(NSNotFound)];
+		}
+
+		if (excluded) {
+			[excludedStrings addIndex:stringIndex];
+		} else if (stringKeywordIndexes[stringIndex].unsignedIntegerValue == NSNotFound) {
+			stringKeywordIndexes[stringIndex] = @(keywordIndex);
+		}
+
+		return YES;
+	};
+
+	__block BOOL scannable = YES;
+
+	for (NSString *keyword in self.excludedKeywords) {
+		if (addKeyword(keyword, NSNotFound, YES) == NO) {
+			scannable = NO;
+
+			break;
+		}
+	}
+
+	if (matchingMethod == TXNicknameHighlightMatchTypeRegularExpression) {
+		NSMutableArray<NSRegularExpression *> *highlightExpressions = [NSMutableArray array];
+
+		for (NSString *keyword in self.highlightKeywords) {
+			NSRegularExpression *expression =
+			[NSRegularExpression regularExpressionWithPattern:keyword
+													  options:NSRegularExpressionCaseInsensitive
+														error:NULL];
+
+			if (expression == nil) {
+				continue;
+			}
+
+			[highlightExpressions addObject:expression];
+		}
+
+		self.highlightExpressions = highlightExpressions;
+	} else if (scannable) {
+		[self.highlightKeywords enumerateObjectsUsingBlock:^(NSString *keyword, NSUInteger index, BOOL *stop) {
+			if (addKeyword(keyword, index, NO) == NO) {
+				scannable = NO;
+
+				*stop = YES;
+			}
+		}];
+	}
+
+	if (scannable == NO || automaton.numberOfStrings == 0) {
+		return;
+	}
+
+	/* Failure links are computed now instead of by the first search
+	 because the automaton is shared by renderers on other threads. */
+	[automaton prepare];
+
+	self.automaton = automaton;
+
+	self.stringKeywordIndexes = stringKeywordIndexes;
+
+	self.excludedStrings = excludedStrings;
+}
+
+#pragma mark -
+#pragma mark Matching
+
+- (void)enumerateKeywordsInString:(NSString *)string withBlock:(BOOL (NS_NOESCAPE ^)(NSRange range))block
+{
+	NSParameterAssert(string != nil);
+	NSParameterAssert(block != NULL);
+
+	NSUInteger stringLength = string.length;
+
+	if (stringLength == 0) {
+		return;
+	}
+
+	NSMutableArray<NSValue *> *excludedRanges = [NSMutableArray array];
+
+	NSDictionary<NSNumber *, NSArray<NSValue *> *> *keywordRanges = nil;
+
+	NSString *foldedString = nil;
+
+	if (self.automaton) {
+		foldedString = [string stringByFoldingWithOptions:NSCaseInsensitiveSearch locale:nil];
+	}
+
+	if (foldedString.length == stringLength) {
+		keywordRanges = [self scanCharactersOfString:foldedString addingExcludedRanges:excludedRanges];
+	} else {
+		for (NSString *excludedKeyword in self.excludedKeywords) {
+			if (excludedKeyword.length == 0) {
+				continue;
+			}
+
+			[string enumerateMatchesOfString:excludedKeyword withBlock:^(NSRange range, BOOL *stop) {
+				[excludedRanges addObject:[NSValue valueWithRange:range]];
+			} options:NSCaseInsensitiveSearch];
+		}
+	}
+
+	if (self.matchingMethod == TXNicknameHighlightMatchTypeRegularExpression) {
+		for (NSRegularExpression *expression in self.highlightExpressions) {
+			NSRange range = [expression rangeOfFirstMatchInString:string options:0 range:NSMakeRange(0, stringLength)];
+
+			if (range.location == NSNotFound) {
+				continue;
+			}
+
+			if ([self offerRange:range excludedRanges:excludedRanges toBlock:block]) {
+				return;
+			}
+		}
+
+		return;
+	}
+
+	if (keywordRanges) {
+		NSArray *keywordIndexes = [keywordRanges.allKeys sortedArrayUsingSelector:@selector(compare:)];
+
+		for (NSNumber *keywordIndex in keywordIndexes) {
+			for (NSValue *range in keywordRanges[keywordIndex]) {
+				if ([self offerRange:range.rangeValue excludedRanges:excludedRanges toBlock:block]) {
+					return;
+				}
+			}
+		}
+
+		return;
+	}
+
+	for (NSString *keyword in self.highlightKeywords) {
+		if (keyword.length == 0) {
+			continue;
+		}
+
+		__block BOOL foundKeyword = NO;
+
+		[string enumerateMatchesOfString:keyword withBlock:^(NSRange range, BOOL *stop) {
+			if ([self offerRange:range excludedRanges:excludedRanges toBlock:block]) {
+				foundKeyword = YES;
+
+				*stop = YES;
+			}
+		} options:NSCaseInsensitiveSearch];
+
+		if (foundKeyword) {
+			return;
+		}
+	}
+}
+
+- (BOOL)offerRange:(NSRange)range excludedRanges:(NSArray<NSValue *> *)excludedRanges toBlock:(BOOL (NS_NOESCAPE ^)(NSRange range))block
+{
+	for (NSValue *excludedRange in excludedRanges) {
+		if (NSIntersectionRange(range, excludedRange.rangeValue).length > 0) {
+			return NO;
+		}
+	}
+
+	return block(range);
+}
+
+/* Returns the ranges of each highlight keyword keyed by its index */
+- (NSDictionary<NSNumber *, NSArray<NSValue *> *> *)scanCharactersOfString:(NSString *)string addingExcludedRanges:(NSMutableArray<NSValue *> *)excludedRanges
+{
+	NSArray<NSNumber *> *stringKeywordIndexes = self.stringKeywordIndexes;
+
+	NSIndexSet *excludedStrings = self.excludedStrings;
+
+	NSMutableDictionary<NSNumber *, NSMutableArray<NSValue *> *> *keywordRanges = [NSMutableDictionary dictionary];
+
+	[self.automaton enumerateMatchesInString:string withBlock:^(NSUInteger stringIndex, NSRange range) {
+		NSValue *rangeValue = [NSValue valueWithRange:range];
+
+		if ([excludedStrings containsIndex:stringIndex]) {
+			[excludedRanges addObject:rangeValue];
+		}
+
+		NSNumber *keywordIndex = stringKeywordIndexes[stringIndex];
+
+		if (keywordIndex.unsignedIntegerValue == NSNotFound) {
+			return;
+		}
+
+		NSMutableArray *ranges = keywordRanges[keywordIndex];
+
+		if (ranges == nil) {
+			ranges = [NSMutableArray array];
+
+			keywordRanges[keywordIndex] = ranges;
+		}
+
+		[ranges addObject:rangeValue];
+	}];
+
+	return keywordRanges;
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -158,6 +158,22 @@ _MessageBuffer.bufferElementInsert = function(placement, html, lineNumbers) /* P
 	}
 };
 
+/* Lines printed while the view was hidden are not added to the buffer.
+When the view becomes visible and there are more of them than can be
+appended, every line in the buffer is replaced by the most recent ones.
+The lines between are loaded from history as the user scrolls upward. */
+_MessageBuffer.bufferElementReplace = function(html, lineNumbers) /* PRIVATE */
+{
+	if (_MessageBuffer._bufferCurrentSize > 0) {
+		_MessageBuffer.resizeBuffer(_MessageBuffer._bufferCurrentSize, true);
+	}
+
+	_MessageBuffer._bufferTopIsComplete = false;
+	_MessageBuffer._bufferBottomIsComplete = true;
+
+	_MessageBuffer.bufferElementInsert("beforeend", html, lineNumbers);
+};
+
 /* ************************************************** */
 /*               Buffer Size Management               */
 /* ************************************************** */
@@ -45,6 +45,7 @@ NS_ASSUME_NONNULL_BEGIN
 #define IRCConnectionConfigFloodControlDefaultMessageCount					6
 #define IRCConnectionConfigFloodControlMinimumMessageCount					1
 #define IRCConnectionConfigFloodControlMaximumMessageCount					60
+#define IRCConnectionConfigWriteCoalescingDefaultMaximumLength				4096
 
 TEXTUAL_EXTERN uint16_t const IRCConnectionDefaultServerPort;
 TEXTUAL_EXTERN uint16_t const IRCConnectionDefaultProxyPort;
@@ -80,6 +81,7 @@ typedef NS_ENUM(NSUInteger, IRCConnectionAddressType)
 @property (readonly) IRCConnectionProxyType proxyType;
 @property (readonly) NSUInteger floodControlDelayInterval;
 @property (readonly) NSUInteger floodControlMaximumMessages;
+@property (readonly) NSUInteger writeCoalescingMaximumLength;
 @property (readonly) uint16_t proxyPort;
 @property (readonly) uint16_t serverPort;
 @property (readonly, copy) NSString *serverAddress;
@@ -104,6 +106,7 @@ typedef NS_ENUM(NSUInteger, IRCConnectionAddressType)
 @property (nonatomic, assign, readwrite) IRCConnectionProxyType proxyType;
 @property (nonatomic, assign, readwrite) NSUInteger floodControlDelayInterval;
 @property (nonatomic, assign, readwrite) NSUInteger floodControlMaximumMessages;
+@property (nonatomic, assign, readwrite) NSUInteger writeCoalescingMaximumLength;
 @property (nonatomic, assign, readwrite) uint16_t proxyPort;
 @property (nonatomic, assign, readwrite) uint16_t serverPort;
 @property (nonatomic, copy, readwrite) NSString *serverAddress;
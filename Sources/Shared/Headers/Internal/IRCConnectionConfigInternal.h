@@ -55,6 +55,7 @@ NS_ASSUME_NONNULL_BEGIN
 	NSString *_serverAddress;
 	NSUInteger _floodControlDelayInterval;
 	NSUInteger _floodControlMaximumMessages;
+	NSUInteger _writeCoalescingMaximumLength;
 	uint16_t _proxyPort;
 	uint16_t _serverPort;
 	NSStringEncoding _primaryEncoding;
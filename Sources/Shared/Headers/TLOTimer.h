@@ -38,7 +38,7 @@
 
 NS_ASSUME_NONNULL_BEGIN
 
-@class TLOTimer;
+@class TLOTimer, TLOTimerWheel;
 
 typedef void (^TLOTimerActionBlock)(TLOTimer *sender);
 
@@ -47,6 +47,11 @@ typedef void (^TLOTimerActionBlock)(TLOTimer *sender);
 @property (nonatomic, strong, nullable) dispatch_queue_t queue; // Defaults to main queue. Changed ignored while active.
 @property (nonatomic, strong, nullable) id context;
 
+/* When a timer wheel is set, intervals of at least one tick of the wheel
+ are scheduled on it instead of on a timer of their own. The action block
+ is then performed on the queue of the wheel. Changes ignored while active. */
+@property (nonatomic, strong, nullable) TLOTimerWheel *timerWheel;
+
 @property (readonly) NSTimeInterval startTime;
 @property (readonly) NSTimeInterval timeRemaining;
 
@@ -0,0 +1,77 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+NS_ASSUME_NONNULL_BEGIN
+
+/* TLOTimerWheel keeps any number of deadlines using a single timer.
+ Deadlines are rounded up to the next tick of the wheel and all blocks
+ that are due on the same tick are performed together. The timer is
+ only armed for ticks that have a block due on them which means the
+ number of wakeups does not grow with the number of blocks scheduled. */
+/* The wheel is hierarchical. Deadlines near in the future are kept
+ in the first level which has one slot per tick. Deadlines further
+ away are kept in coarser levels and move towards the first level
+ as the wheel turns. Scheduling and cancelling are constant time. */
+@interface TLOTimerWheelEntry : NSObject
+- (instancetype)init NS_UNAVAILABLE;
+@end
+
+@interface TLOTimerWheel : NSObject
+@property (readonly) NSTimeInterval tickInterval;
+@property (readonly) dispatch_queue_t queue;
+
+/* Statistics */
+@property (readonly) NSUInteger numberOfScheduledBlocks;
+@property (readonly) NSUInteger numberOfWakeups;
+@property (readonly) NSUInteger numberOfBlocksPerformed;
+
+- (instancetype)init; // One second ticks on the main queue
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval onQueue:(nullable dispatch_queue_t)queue NS_DESIGNATED_INITIALIZER;
+
+/* Blocks are performed on -queue */
+- (TLOTimerWheelEntry *)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay;
+
+/* Replaces the block performed by an entry without changing its deadline */
+- (void)replaceBlock:(dispatch_block_t)block forEntry:(TLOTimerWheelEntry *)entry;
+
+- (void)cancelEntry:(TLOTimerWheelEntry *)entry;
+
+- (void)invalidate; // Cancels all entries and releases the timer
+@end
+
+NS_ASSUME_NONNULL_END
@@ -76,6 +76,10 @@ uint16_t const IRCConnectionDefaultProxyPort = 1080;
 	if (self->_floodControlMaximumMessages == 0) {
 		self->_floodControlMaximumMessages = IRCConnectionConfigFloodControlDefaultMessageCount;
 	}
+
+	if (self->_writeCoalescingMaximumLength == 0) {
+		self->_writeCoalescingMaximumLength = IRCConnectionConfigWriteCoalescingDefaultMaximumLength;
+	}
 }
 
 - (BOOL)populateWithDecoder:(NSCoder *)aDecoder
@@ -87,6 +91,7 @@ uint16_t const IRCConnectionDefaultProxyPort = 1080;
 	self->_connectionShouldValidateCertificateChain = [aDecoder decodeBoolForKey:@"connectionShouldValidateCertificateChain"];
 	self->_floodControlDelayInterval = [aDecoder decodeUnsignedIntegerForKey:@"floodControlDelayInterval"];
 	self->_floodControlMaximumMessages = [aDecoder decodeUnsignedIntegerForKey:@"floodControlMaximumMessages"];
+	self->_writeCoalescingMaximumLength = [aDecoder decodeUnsignedIntegerForKey:@"writeCoalescingMaximumLength"];
 	self->_identityClientSideCertificate = [aDecoder decodeDataForKey:@"identityClientSideCertificate"];
 	self->_proxyAddress = [aDecoder decodeStringForKey:@"proxyAddress"];
 	self->_proxyPassword = [aDecoder decodeStringForKey:@"proxyPassword"];
@@ -113,6 +118,7 @@ uint16_t const IRCConnectionDefaultProxyPort = 1080;
 	[aCoder encodeBool:self->_connectionShouldValidateCertificateChain forKey:@"connectionShouldValidateCertificateChain"];
 	[aCoder encodeUnsignedInteger:self->_floodControlDelayInterval forKey:@"floodControlDelayInterval"];
 	[aCoder encodeUnsignedInteger:self->_floodControlMaximumMessages forKey:@"floodControlMaximumMessages"];
+	[aCoder encodeUnsignedInteger:self->_writeCoalescingMaximumLength forKey:@"writeCoalescingMaximumLength"];
 	[aCoder maybeEncodeObject:self->_identityClientSideCertificate forKey:@"identityClientSideCertificate"];
 	[aCoder maybeEncodeObject:self->_proxyAddress forKey:@"proxyAddress"];
 	[aCoder maybeEncodeObject:self->_proxyPassword forKey:@"proxyPassword"];
@@ -142,6 +148,7 @@ uint16_t const IRCConnectionDefaultProxyPort = 1080;
 	object->_connectionShouldValidateCertificateChain = self->_connectionShouldValidateCertificateChain;
 	object->_floodControlDelayInterval = self->_floodControlDelayInterval;
 	object->_floodControlMaximumMessages = self->_floodControlMaximumMessages;
+	object->_writeCoalescingMaximumLength = self->_writeCoalescingMaximumLength;
 	object->_identityClientSideCertificate = self->_identityClientSideCertificate;
 	object->_proxyAddress = self->_proxyAddress;
 	object->_proxyPassword = self->_proxyPassword;
@@ -175,6 +182,7 @@ uint16_t const IRCConnectionDefaultProxyPort = 1080;
 @dynamic connectionShouldValidateCertificateChain;
 @dynamic floodControlDelayInterval;
 @dynamic floodControlMaximumMessages;
+@dynamic writeCoalescingMaximumLength;
 @dynamic identityClientSideCertificate;
 @dynamic proxyAddress;
 @dynamic proxyPassword;
@@ -296,6 +304,13 @@ uint16_t const IRCConnectionDefaultProxyPort = 1080;
 	}
 }
 
+- (void)setWriteCoalescingMaximumLength:(NSUInteger)writeCoalescingMaximumLength
+{
+	if (self->_writeCoalescingMaximumLength != writeCoalescingMaximumLength) {
+		self->_writeCoalescingMaximumLength = writeCoalescingMaximumLength;
+	}
+}
+
 - (void)setProxyPort:(uint16_t)proxyPort
 {
 	if (self->_proxyPort != proxyPort) {
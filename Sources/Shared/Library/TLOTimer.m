@@ -37,6 +37,7 @@
  *********************************************************************** */
 
 #import "TLOTimer.h"
+#import "TLOTimerWheel.h"
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -48,6 +49,8 @@ NS_ASSUME_NONNULL_BEGIN
 @property (nonatomic, assign, readwrite) NSUInteger iterations;
 @property (nonatomic, assign, readwrite) NSUInteger currentIteration;
 @property (nonatomic, strong, nullable) dispatch_source_t timerSource;
+@property (nonatomic, strong, nullable) TLOTimerWheelEntry *timerWheelEntry;
+@property (nonatomic, strong, nullable) TLOTimerWheel *activeTimerWheel;
 @end
 
 @implementation TLOTimer
@@ -101,7 +104,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (BOOL)timerIsActive
 {
-	return (self.timerSource != nil);
+	return (self.timerSource != nil || self.timerWheelEntry != nil);
 }
 
 - (NSTimeInterval)timeRemaining
@@ -125,6 +128,21 @@ NS_ASSUME_NONNULL_BEGIN
 
 	[self stop];
 
+	self.interval = timerInterval;
+	self.repeatTimer = repeatTimer;
+	self.iterations = iterations;
+	self.currentIteration = 0;
+
+	TLOTimerWheel *timerWheel = self.timerWheel;
+
+	if (timerWheel && timerInterval >= timerWheel.tickInterval) {
+		self.activeTimerWheel = timerWheel;
+
+		[self scheduleOnTimerWheel];
+
+		return;
+	}
+
 	dispatch_queue_t sourceQueue = self.queue;
 
 	if (sourceQueue == nil) {
@@ -135,11 +153,6 @@ NS_ASSUME_NONNULL_BEGIN
 		[self fireTimer];
 	}, timerInterval, repeatTimer);
 
-	self.interval = timerInterval;
-	self.repeatTimer = repeatTimer;
-	self.iterations = iterations;
-	self.currentIteration = 0;
-
 	self.timerSource = timerSource;
 
 	XRResumeScheduledBlock(timerSource);
@@ -147,8 +160,28 @@ NS_ASSUME_NONNULL_BEGIN
 	self.startTime = CFAbsoluteTimeGetCurrent();
 }
 
+- (void)scheduleOnTimerWheel
+{
+	self.timerWheelEntry =
+	[self.activeTimerWheel scheduleBlock:^{
+		[self fireTimer];
+	} afterDelay:self.interval];
+
+	self.startTime = CFAbsoluteTimeGetCurrent();
+}
+
 - (void)stop
 {
+	TLOTimerWheelEntry *timerWheelEntry = self.timerWheelEntry;
+
+	if (timerWheelEntry) {
+		[self.activeTimerWheel cancelEntry:timerWheelEntry];
+
+		self.timerWheelEntry = nil;
+
+		self.activeTimerWheel = nil;
+	}
+
 	dispatch_source_t timerSource = self.timerSource;
 
 	if (timerSource == nil) {
@@ -184,6 +217,18 @@ NS_ASSUME_NONNULL_BEGIN
 
 	[self stopIfNeeded];
 
+	/* Entries of a timer wheel are performed once which means
+	 repeating timers are scheduled again for the next interval. */
+	if (self.timerWheelEntry) {
+		if (self.repeatTimer) {
+			[self scheduleOnTimerWheel];
+		} else {
+			self.timerWheelEntry = nil;
+
+			self.activeTimerWheel = nil;
+		}
+	}
+
 	actionBlock(self);
 }
 
@@ -0,0 +1,470 @@
+/* *********************************************************************
+ *                  _____         _               _
+ *                 |_   _|____  _| |_ _   _  __ _| |
+ *                   | |/ _ \ \/ / __| | | |/ _` | |
+ *                   | |  __/>  <| |_| |_| | (_| | |
+ *                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+ *
+ * Copyright (c) 2008 - 2010 Satoshi Nakagawa <psychs AT limechat DOT net>
+ * Copyright (c) 2010 - 2018 Codeux Software, LLC & respective contributors.
+ *       Please see Acknowledgements.pdf for additional information.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of Textual, "Codeux Software, LLC", nor the
+ *    names of its contributors may be used to endorse or promote products
+ *    derived from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ *
+ *********************************************************************** */
+
+#import "TLOTimerWheel.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+#define _defaultTickInterval		1.0
+
+#define _levelCount			4
+#define _slotBits			6
+#define _slotCount			(1 << _slotBits)
+#define _slotMask			(_slotCount - 1)
+
+/* Deadlines further away than the last level can hold are
+ clamped to it. With one second ticks that is about 194 days. */
+#define _maximumDelayInTicks		((1ULL << (_slotBits * _levelCount)) - 1)
+
+@interface TLOTimerWheelEntry ()
+@property (nonatomic, copy, nullable) dispatch_block_t block;
+@property (nonatomic, assign) uint64_t deadline;
+@property (nonatomic, assign) NSUInteger slotIndex; // NSNotFound when not in a slot
+@end
+
+@interface TLOTimerWheel ()
+@property (nonatomic, assign, readwrite) NSTimeInterval tickInterval;
+@property (nonatomic, strong, readwrite) dispatch_queue_t queue;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfScheduledBlocks;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfWakeups;
+@property (nonatomic, assign, readwrite) NSUInteger numberOfBlocksPerformed;
+@property (nonatomic, copy) NSArray<NSMutableSet<TLOTimerWheelEntry *> *> *slots;
+@property (nonatomic, assign) NSTimeInterval originTime;
+@property (nonatomic, assign) uint64_t currentTick; // Next tick to be processed
+@property (nonatomic, assign) uint64_t armedTick; // UINT64_MAX when not armed
+@property (nonatomic, strong, nullable) dispatch_source_t timerSource;
+@end
+
+@implementation TLOTimerWheelEntry
+
+- (instancetype)init
+{
+	[self doesNotRecognizeSelector:_cmd];
+
+	return nil;
+}
+
+- (instancetype)initWithBlock:(dispatch_block_t)block
+{
+	NSParameterAssert(block != NULL);
+
+	if ((self = [super init])) {
+		self.block = block;
+
+		self.slotIndex = NSNotFound;
+
+		return self;
+	}
+
+	return nil;
+}
+
+@end
+
+#pragma mark -
+
+@implementation TLOTimerWheel
+
+- (instancetype)init
+{
+	return [self initWithTickInterval:_defaultTickInterval onQueue:nil];
+}
+
+- (instancetype)initWithTickInterval:(NSTimeInterval)tickInterval onQueue:(nullable dispatch_queue_t)queue
+{
+	NSParameterAssert(tickInterval > 0);
+
+	if ((self = [super init])) {
+		self.tickInterval = tickInterval;
+
+		if (queue == nil) {
+			queue = dispatch_get_main_queue();
+		}
+
+		self.queue = queue;
+
+		[self prepareInitialState];
+
+		return self;
+	}
+
+	return nil;
+}
+
+- (void)prepareInitialState
+{
+	NSMutableArray *slots = [NSMutableArray arrayWithCapacity:(_levelCount * _slotCount)];
+
+	for (NSUInteger i = 0; i < (_levelCount * _slotCount); i++) {
+		[slots addObject:[NSMutableSet set]];
+	}
+
+	self.slots = slots;
+
+	self.originTime = [NSProcessInfo processInfo].systemUptime;
+
+	self.armedTick = UINT64_MAX;
+
+	dispatch_source_t timerSource = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, self.queue);
+
+	__weak typeof(self) weakSelf = self;
+
+	dispatch_source_set_event_handler(timerSource, ^{
+		[weakSelf timerFired];
+	});
+
+	dispatch_source_set_timer(timerSource, DISPATCH_TIME_FOREVER, DISPATCH_TIME_FOREVER, 0);
+
+	dispatch_resume(timerSource);
+
+	self.timerSource = timerSource;
+}
+
+- (void)dealloc
+{
+	[self invalidate];
+}
+
+- (void)invalidate
+{
+	@synchronized (self) {
+		for (NSMutableSet *slot in self.slots) {
+			for (TLOTimerWheelEntry *entry in slot) {
+				entry.block = nil;
+
+				entry.slotIndex = NSNotFound;
+			}
+
+			[slot removeAllObjects];
+		}
+
+		self.numberOfScheduledBlocks = 0;
+
+		dispatch_source_t timerSource = self.timerSource;
+
+		if (timerSource == nil) {
+			return;
+		}
+
+		dispatch_source_cancel(timerSource);
+
+		self.timerSource = nil;
+	}
+}
+
+#pragma mark -
+#pragma mark Scheduling
+
+- (NSTimeInterval)elapsedTime
+{
+	return ([NSProcessInfo processInfo].systemUptime - self.originTime);
+}
+
+- (uint64_t)elapsedTicks
+{
+	return (uint64_t)([self elapsedTime] / self.tickInterval);
+}
+
+- (TLOTimerWheelEntry *)scheduleBlock:(dispatch_block_t)block afterDelay:(NSTimeInterval)delay
+{
+	NSParameterAssert(block != NULL);
+
+	TLOTimerWheelEntry *entry = [[TLOTimerWheelEntry alloc] initWithBlock:block];
+
+	@synchronized (self) {
+		NSTimeInterval elapsedTime = [self elapsedTime];
+
+		uint64_t elapsedTicks = (uint64_t)(elapsedTime / self.tickInterval);
+
+		/* The wheel does not turn while it is empty which means
+		 it is moved forward to the present without any work. */
+		if (self.numberOfScheduledBlocks == 0 && self.currentTick < elapsedTicks) {
+			self.currentTick = elapsedTicks;
+		}
+
+		/* The deadline is the first tick at or after the moment the block
+		 is due. Rounding the delay up on its own would ignore how far into
+		 the current tick we are and could perform the block early. */
+		double deadline = ceil((elapsedTime + delay) / self.tickInterval);
+
+		if (deadline <= elapsedTicks) {
+			entry.deadline = (elapsedTicks + 1);
+		} else if ((deadline - elapsedTicks) > _maximumDelayInTicks) {
+			entry.deadline = (elapsedTicks + _maximumDelayInTicks);
+		} else {
+			entry.deadline = (uint64_t)deadline;
+		}
+
+		[self insertEntry:entry];
+
+		self.numberOfScheduledBlocks += 1;
+
+		[self armTimer];
+	}
+
+	return entry;
+}
+
+- (void)replaceBlock:(dispatch_block_t)block forEntry:(TLOTimerWheelEntry *)entry
+{
+	NSParameterAssert(block != NULL);
+	NSParameterAssert(entry != nil);
+
+	@synchronized (self) {
+		if (entry.block == nil) {
+			return; // Entry was performed or cancelled
+		}
+
+		entry.block = block;
+	}
+}
+
+- (void)cancelEntry:(TLOTimerWheelEntry *)entry
+{
+	NSParameterAssert(entry != nil);
+
+	@synchronized (self) {
+		entry.block = nil;
+
+		NSUInteger slotIndex = entry.slotIndex;
+
+		if (slotIndex == NSNotFound) {
+			return;
+		}
+
+		[self.slots[slotIndex] removeObject:entry];
+
+		entry.slotIndex = NSNotFound;
+
+		self.numberOfScheduledBlocks -= 1;
+
+		/* The timer is left armed when the wheel becomes empty.
+		 It will wake once, find nothing, and not be armed again. */
+	}
+}
+
+/* Must be called with lock held */
+- (void)insertEntry:(TLOTimerWheelEntry *)entry
+{
+	uint64_t currentTick = self.currentTick;
+
+	uint64_t deadline = entry.deadline;
+
+	if (deadline < currentTick) {
+		deadline = currentTick;
+	} else if ((deadline - currentTick) > _maximumDelayInTicks) {
+		deadline = (currentTick + _maximumDelayInTicks);
+	}
+
+	entry.deadline = deadline;
+
+	uint64_t delta = (deadline - currentTick);
+
+	NSUInteger level = 0;
+
+	while (level < (_levelCount - 1) && delta >= (1ULL << (_slotBits * (level + 1)))) {
+		level += 1;
+	}
+
+	NSUInteger slotIndex = ((level * _slotCount) + ((deadline >> (_slotBits * level)) & _slotMask));
+
+	[self.slots[slotIndex] addObject:entry];
+
+	entry.slotIndex = slotIndex;
+}
+
+#pragma mark -
+#pragma mark Turning
+
+/* Must be called with lock held */
+- (void)cascadeSlotAtIndex:(NSUInteger)slotIndex
+{
+	NSMutableSet *slot = self.slots[slotIndex];
+
+	if (slot.count == 0) {
+		return;
+	}
+
+	NSArray *entries = slot.allObjects;
+
+	[slot removeAllObjects];
+
+	for (TLOTimerWheelEntry *entry in entries) {
+		[self insertEntry:entry];
+	}
+}
+
+/* Must be called with lock held */
+- (void)processCurrentTickAddingDueEntriesTo:(NSMutableArray<TLOTimerWheelEntry *> *)dueEntries
+{
+	uint64_t tick = self.currentTick;
+
+	NSUInteger index = (tick & _slotMask);
+
+	/* When the first level comes around, entries in the next slot of the
+	 second level are moved down. When that level comes around too, the
+	 entries of the level above it are moved down, and so on. */
+	if (index == 0) {
+		for (NSUInteger level = 1; level < _levelCount; level++) {
+			NSUInteger levelIndex = ((tick >> (_slotBits * level)) & _slotMask);
+
+			[self cascadeSlotAtIndex:((level * _slotCount) + levelIndex)];
+
+			if (levelIndex != 0) {
+				break;
+			}
+		}
+	}
+
+	self.currentTick = (tick + 1);
+
+	NSMutableSet *slot = self.slots[index];
+
+	if (slot.count == 0) {
+		return;
+	}
+
+	for (TLOTimerWheelEntry *entry in slot) {
+		entry.slotIndex = NSNotFound;
+
+		[dueEntries addObject:entry];
+	}
+
+	self.numberOfScheduledBlocks -= slot.count;
+
+	[slot removeAllObjects];
+}
+
+/* Must be called with lock held */
+- (uint64_t)nextTickToWake
+{
+	uint64_t tick = self.currentTick;
+
+	/* Wake when the first level comes around so that
+	 entries in the levels above it can be moved down. */
+	if ((tick & _slotMask) == 0) {
+		return tick;
+	}
+
+	uint64_t nextRound = ((tick | _slotMask) + 1);
+
+	for (uint64_t nextTick = tick; nextTick < nextRound; nextTick++) {
+		if (self.slots[(nextTick & _slotMask)].count > 0) {
+			return nextTick;
+		}
+	}
+
+	return nextRound;
+}
+
+/* Must be called with lock held */
+- (void)armTimer
+{
+	dispatch_source_t timerSource = self.timerSource;
+
+	if (timerSource == nil) {
+		return;
+	}
+
+	if (self.numberOfScheduledBlocks == 0) {
+		return;
+	}
+
+	uint64_t nextTick = [self nextTickToWake];
+
+	/* A timer armed for an earlier tick will arm again when it fires */
+	if (nextTick >= self.armedTick) {
+		return;
+	}
+
+	self.armedTick = nextTick;
+
+	NSTimeInterval fireTime = (self.originTime + (nextTick * self.tickInterval));
+
+	NSTimeInterval fireDelay = (fireTime - [NSProcessInfo processInfo].systemUptime);
+
+	if (fireDelay < 0) {
+		fireDelay = 0;
+	}
+
+	uint64_t leeway = (uint64_t)((self.tickInterval / 10.0) * NSEC_PER_SEC);
+
+	dispatch_source_set_timer(timerSource, dispatch_time(DISPATCH_TIME_NOW, (int64_t)(fireDelay * NSEC_PER_SEC)), DISPATCH_TIME_FOREVER, leeway);
+}
+
+- (void)timerFired
+{
+	NSMutableArray<TLOTimerWheelEntry *> *dueEntries = [NSMutableArray array];
+
+	@synchronized (self) {
+		self.numberOfWakeups += 1;
+
+		self.armedTick = UINT64_MAX;
+
+		uint64_t elapsedTicks = [self elapsedTicks];
+
+		while (self.currentTick <= elapsedTicks && self.numberOfScheduledBlocks > 0) {
+			[self processCurrentTickAddingDueEntriesTo:dueEntries];
+		}
+
+		[self armTimer];
+	}
+
+	for (TLOTimerWheelEntry *entry in dueEntries) {
+		dispatch_block_t block = nil;
+
+		/* An entry can be cancelled by a block performed before it */
+		@synchronized (self) {
+			block = entry.block;
+
+			entry.block = nil;
+
+			if (block) {
+				self.numberOfBlocksPerformed += 1;
+			}
+		}
+
+		if (block) {
+			block();
+		}
+	}
+}
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -529,26 +529,41 @@ typedef NS_ENUM(NSUInteger, HLSHistoricLogUniqueIdentifierFetchType)
 {
 	NSParameterAssert(logLine != nil);
 
-	HLSHistoricLogViewContext *viewContext = [self contextForView:logLine.viewIdentifier];
+	[self writeLogLines:@[logLine]];
+}
+
+- (void)writeLogLines:(NSArray<TVCLogLineXPC *> *)logLines
+{
+	NSParameterAssert(logLines != nil);
+
+	if (logLines.count == 0) {
+		return;
+	}
+
+	HLSHistoricLogViewContext *viewContext = [self contextForView:logLines.firstObject.viewIdentifier];
 
 	[viewContext performBlockAndWait:^{
 		NSEntityDescription *entity = [NSEntityDescription entityForName:@"LogLine2" inManagedObjectContext:viewContext];
 
-		NSManagedObject *newEntry = [[NSManagedObject alloc] initWithEntity:entity insertIntoManagedObjectContext:viewContext];
+		NSNumber *creationDate = @([[NSDate date] timeIntervalSince1970]);
 
-		NSUInteger newestIdentifier = [self _incrementNewestIdentifierInViewContext:viewContext];
+		for (TVCLogLineXPC *logLine in logLines) {
+			NSManagedObject *newEntry = [[NSManagedObject alloc] initWithEntity:entity insertIntoManagedObjectContext:viewContext];
 
-		[newEntry setValue:@(newestIdentifier) forKey:@"entryIdentifier"];
+			NSUInteger newestIdentifier = [self _incrementNewestIdentifierInViewContext:viewContext];
 
-		[newEntry setValue:@([[NSDate date] timeIntervalSince1970]) forKey:@"entryCreationDate"];
+			[newEntry setValue:@(newestIdentifier) forKey:@"entryIdentifier"];
 
-		[newEntry setValue:logLine.viewIdentifier forKey:@"logLineViewIdentifier"];
+			[newEntry setValue:creationDate forKey:@"entryCreationDate"];
 
-		[newEntry setValue:logLine.data forKey:@"logLineData"];
+			[newEntry setValue:logLine.viewIdentifier forKey:@"logLineViewIdentifier"];
 
-		[newEntry setValue:logLine.uniqueIdentifier forKey:@"logLineUniqueIdentifier"];
+			[newEntry setValue:logLine.data forKey:@"logLineData"];
 
-		[newEntry setValue:@(logLine.sessionIdentifier) forKey:@"sessionIdentifier"];
+			[newEntry setValue:logLine.uniqueIdentifier forKey:@"logLineUniqueIdentifier"];
+
+			[newEntry setValue:@(logLine.sessionIdentifier) forKey:@"sessionIdentifier"];
+		}
 
 		[self scheduleResizeInViewContext:viewContext];
 	}];
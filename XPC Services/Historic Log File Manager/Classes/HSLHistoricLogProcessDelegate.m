@@ -68,6 +68,11 @@ NS_ASSUME_NONNULL_BEGIN
 					argumentIndex:0
 						  ofReply:YES];
 
+	[exportedInterface setClasses:[NSSet setWithObjects:[NSArray class], [TVCLogLineXPC class], nil]
+					  forSelector:@selector(writeLogLines:)
+					argumentIndex:0
+						  ofReply:NO];
+
 	newConnection.exportedInterface = exportedInterface;
 
 	NSXPCInterface *remoteObjectInterface = [NSXPCInterface interfaceWithProtocol:@protocol(HLSHistoricLogClientProtocol)];
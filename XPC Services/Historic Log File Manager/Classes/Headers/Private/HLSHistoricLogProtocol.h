@@ -48,6 +48,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)openDatabaseAtPath:(NSString *)path withCompletionBlock:(void (NS_NOESCAPE ^ _Nullable)(BOOL success))completionBlock;
 
 - (void)writeLogLine:(TVCLogLineXPC *)logLine;
+- (void)writeLogLines:(NSArray<TVCLogLineXPC *> *)logLines; // All log lines must belong to the same view
 
 - (void)saveDataWithCompletionBlock:(void (NS_NOESCAPE ^ _Nullable)(void))completionBlock;
 
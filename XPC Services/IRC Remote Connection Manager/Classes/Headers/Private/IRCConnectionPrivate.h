@@ -45,7 +45,7 @@ NS_ASSUME_NONNULL_BEGIN
 - (void)open;
 - (void)close;
 
-- (void)sendData:(NSData *)data bypassQueue:(BOOL)bypassQueue;
+- (void)sendData:(NSData *)data lane:(RCMSendQueueLane)lane;
 
 - (void)enforceFloodControl;
 
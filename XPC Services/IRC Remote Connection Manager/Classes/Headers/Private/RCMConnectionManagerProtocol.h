@@ -49,6 +49,15 @@ typedef void (^RCMSecureConnectionInformationCompletionBlock)(
 											  SSLCipherSuite cipherSuites,
 											  NSArray<NSData *> *certificateChain);
 
+/* Lines waiting to be sent are placed in a lane. A lane is only
+ sent from once every lane before it is empty. */
+typedef NS_ENUM(NSUInteger, RCMSendQueueLane)
+{
+	RCMSendQueueLaneControl = 0, // PONG, and CAP and AUTHENTICATE after registration - exempt from flood control
+	RCMSendQueueLaneInteractive = 1, // Everything else, in the order it was sent
+	RCMSendQueueLaneBulk = 2 // WHO and ISON polling, and autojoin
+};
+
 #pragma mark -
 #pragma mark Server Protocol
 
@@ -60,8 +69,8 @@ typedef void (^RCMSecureConnectionInformationCompletionBlock)(
 - (void)close;
 
 /* -sendData: does not append \r\n. It is assumed client does that. */
-- (void)sendData:(NSData *)data;
-- (void)sendData:(NSData *)data bypassQueue:(BOOL)bypassQueue;
+- (void)sendData:(NSData *)data; // RCMSendQueueLaneInteractive
+- (void)sendData:(NSData *)data lane:(RCMSendQueueLane)lane;
 
 - (void)exportSecureConnectionInformation:(NS_NOESCAPE RCMSecureConnectionInformationCompletionBlock)completionBlock;
 
@@ -97,6 +106,7 @@ typedef void (^RCMSecureConnectionInformationCompletionBlock)(
 - (void)ircConnectionDidCloseReadStream;
 - (void)ircConnectionDidDisconnectWithError:(nullable NSError *)disconnectError;
 - (void)ircConnectionDidReceiveData:(NSData *)data;
+- (void)ircConnectionDidReceiveLines:(NSArray<NSData *> *)lines; // Lines are in the order they were received
 - (void)ircConnectionRequestInsecureCertificateTrust:(RCMTrustResponse)trustBlock;
 - (void)ircConnectionWillSendData:(NSData *)data;
 - (void)ircConnectionDidSendData;
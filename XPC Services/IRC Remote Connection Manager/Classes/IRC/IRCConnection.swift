@@ -44,17 +44,41 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 	fileprivate let serviceConnection: NSXPCConnection
 
-	fileprivate var sendQueue: [Data] = []
+	/* Lines waiting to be sent are placed in one of several lanes.
+	 The lanes are indexed by RCMSendQueueLane whose raw values are
+	 ordered by priority. A lane is only drained once every lane
+	 ahead of it is empty, so a burst of WHO requests queued in the
+	 bulk lane cannot delay a message typed by the user. */
+	fileprivate var sendQueues = [ConnectionSendQueue](repeating: ConnectionSendQueue(), count: 3)
+
+	/* Flood control is a token bucket. The bucket holds up to
+	 floodControlMaximumMessages tokens and is refilled at a rate of
+	 floodControlMaximumMessages tokens every floodControlDelayInterval.
+	 Each line costs one token plus a token for every 512 bytes it
+	 is long, which is close to how servers account for flood. */
+	/* Nothing is scheduled while the bucket can cover the next line.
+	 When it can't, a single wakeup is scheduled for the moment the
+	 bucket will have refilled enough to send it. */
+	fileprivate var floodControlTokens = 0.0
+	fileprivate var floodControlLastRefill: UInt64 = 0
+	fileprivate var floodControlWakeupScheduled = false
+	fileprivate var floodControlEnforced = false
 
-	fileprivate lazy var floodControlTimer: TLOTimer =
-	{
-		return TLOTimer(actionBlock: { [weak self] _ in
-			self?.onFloodControlTimer()
-		}, on: DispatchQueue.global(qos: .default))
-	}()
+	fileprivate let floodControlBytesPerToken = 512.0
 
-	fileprivate var floodControlCurrentMessageCount = 0
-	fileprivate var floodControlEnforced = false
+	/* Lines received are delivered to the app in batches to reduce
+	 the number of messages sent over the XPC connection. */
+	/* A line received while the connection is idle is delivered right
+	 away. Lines received shortly after a delivery are held until the
+	 batch is full or the deadline passes, whichever happens first. */
+	fileprivate var receiveBatch: [Data] = []
+	fileprivate var receiveBatchLength = 0
+	fileprivate var receiveBatchFlushScheduled = false
+	fileprivate var receiveBatchLastFlush: UInt64 = 0
+
+	fileprivate let receiveBatchMaximumLines = 500
+	fileprivate let receiveBatchMaximumLength = (1024 * 256) // 256 kilobytes
+	fileprivate let receiveBatchDeadline = 500 // microseconds
 
 	fileprivate var workerQueue: DispatchQueue?
 
@@ -123,8 +147,6 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 		createWorkerDispatchQueue()
 
-		startFloodControlTimer()
-
 		disconnectingManually = true
 
 		socket.open()
@@ -145,8 +167,6 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 		clearSendQueue()
 
-		stopFloodControlTimer()
-
 		disconnectingManually = true
 
 		socket.close()
@@ -162,8 +182,6 @@ final class Connection: NSObject, ConnectionSocketDelegate
 			floodControlEnforced = false
 
 			clearSendQueue()
-
-			stopFloodControlTimer()
 		}
 
 		destroyWorkerDispatchQueue()
@@ -171,112 +189,192 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 	// MARK: - Send Queue
 
-	fileprivate var sendQueueCount: Int
+	@objc
+	final func clearSendQueue()
 	{
-		var sendQueueCount = 0
-
 		workerQueue?.sync {
-			sendQueueCount = sendQueue.count
+			for index in sendQueues.indices {
+				sendQueues[index].removeAll()
+			}
 		}
-
-		return sendQueueCount
 	}
 
-	fileprivate func nextEntryInSendQueue() -> Data?
+	/// Removes lines from the front of the lanes, in order of priority,
+	/// for as long as flood control allows and joins them into a single write.
+	/// nextWriteInSendQueue() must be called on the worker queue
+	fileprivate func nextWriteInSendQueue() -> Data?
 	{
-		var nextEntry: Data?
+		floodControlRefill()
 
-		workerQueue?.sync {
-			nextEntry = sendQueue.first
+		let maximumLength = Int(config.writeCoalescingMaximumLength)
+
+		var data = Data()
+
+		nextLine: while (true) {
+			/* Lanes are accessed by index so that removing a line
+			 doesn't force a copy of the lane being iterated. */
+			for index in sendQueues.indices {
+				guard let line = sendQueues[index].first else {
+					continue
+				}
+
+				if (data.isEmpty == false && (data.count + line.count) > maximumLength) {
+					break nextLine
+				}
+
+				let cost = floodControlCost(of: line)
+
+				/* Lines in the control lane are not held back by flood control.
+				 This lane carries PONG replies which must not be delayed. */
+				if (floodControlEnforced && index != Int(RCMSendQueueLane.control.rawValue)) {
+					/* Lines longer than the bucket can hold are sent once it is full */
+					let tokensRequired = min(cost, Double(config.floodControlMaximumMessages))
+
+					if (floodControlTokens < tokensRequired) {
+						floodControlScheduleWakeup(for: tokensRequired)
+
+						break nextLine
+					}
+				}
+
+				floodControlTokens -= cost
+
+				data.append(line)
+
+				sendQueues[index].removeFirst()
+
+				continue nextLine
+			}
+
+			break
+		}
+
+		if (data.isEmpty) {
+			return nil
 		}
 
-		return nextEntry
+		return data
 	}
 
-	fileprivate func sendQueue(add data: Data)
+	/// sendNextWrite() must be called on the worker queue
+	fileprivate func sendNextWrite()
 	{
-		workerQueue?.sync {
-			sendQueue.append(data)
+		/* The socket only allows one write at a time. Checking
+		 whether it is sending and writing to it are performed
+		 together so that a flood control wakeup and the socket
+		 cannot both begin a write at the same time. */
+		if (socket.sending) {
+			return
 		}
+
+		guard let data = nextWriteInSendQueue() else {
+			return
+		}
+
+		socket.write(data)
 	}
 
-	fileprivate func sendQueue(remove data: Data)
+	fileprivate func tryToSend()
 	{
 		workerQueue?.sync {
-			if let index = sendQueue.firstIndex(of: data) {
-				sendQueue.remove(at: index)
-			}
+			sendNextWrite()
 		}
 	}
 
-	@objc
-	final func clearSendQueue()
+	@objc(sendData:lane:)
+	final func send(_ data: Data, lane: RCMSendQueueLane)
 	{
+		if (socket.disconnected) {
+			LogToConsoleError("Cannot send data while disconnected")
+
+			return
+		}
+
 		workerQueue?.sync {
-			sendQueue.removeAll()
+			sendQueues[Int(lane.rawValue)].append(data)
+
+			sendNextWrite()
 		}
 	}
 
-	@discardableResult
-	fileprivate func tryToSend() -> Bool
+	// MARK: - Receive Batch
+
+	fileprivate func receiveBatch(add data: Data)
 	{
-		if (socket.sending) {
-			return false
-		}
+		guard let workerQueue = workerQueue else {
+			remoteObjectProxy.ircConnectionDidReceive(data)
 
-		if (sendQueueCount == 0) {
-			return false
+			return
 		}
 
-		if (floodControlEnforced) {
-			if (floodControlCurrentMessageCount >= config.floodControlMaximumMessages) {
-				return false
+		workerQueue.sync {
+			receiveBatch.append(data)
+
+			receiveBatchLength += data.count
+
+			if (receiveBatch.count >= receiveBatchMaximumLines ||
+				receiveBatchLength >= receiveBatchMaximumLength)
+			{
+				flushReceiveBatch()
+
+				return
 			}
-		}
 
-		floodControlCurrentMessageCount += 1
+			if (receiveBatchFlushScheduled) {
+				return
+			}
 
-		sendNextLine()
+			let currentTime = DispatchTime.now().uptimeNanoseconds
 
-		return true
-	}
+			let deadlineInNanoseconds = UInt64(receiveBatchDeadline * 1000)
 
-	fileprivate func sendNextLine()
-	{
-		guard let line = nextEntryInSendQueue() else {
-			return
-		}
+			if ((currentTime - receiveBatchLastFlush) > deadlineInNanoseconds) {
+				flushReceiveBatch()
+
+				return
+			}
+
+			receiveBatchFlushScheduled = true
+
+			workerQueue.asyncAfter(deadline: .now() + .microseconds(receiveBatchDeadline)) { [weak self] in
+				guard let self = self else {
+					return
+				}
 
-		send(line, removeFromQueue: true)
+				self.receiveBatchFlushScheduled = false
+
+				self.flushReceiveBatch()
+			}
+		}
 	}
 
-	@objc(sendData:bypassQueue:)
-	final func send(_ data: Data, bypassQueue: Bool = false)
+	/// flushReceiveBatch() must be called on the worker queue
+	fileprivate func flushReceiveBatch()
 	{
-		if (socket.disconnected) {
-			LogToConsoleError("Cannot send data while disconnected")
+		receiveBatchLastFlush = DispatchTime.now().uptimeNanoseconds
 
+		if (receiveBatch.isEmpty) {
 			return
 		}
 
-		if (bypassQueue) {
-			send(data, removeFromQueue: false)
-
-			return
+		if (receiveBatch.count == 1) {
+			remoteObjectProxy.ircConnectionDidReceive(receiveBatch[0])
+		} else {
+			remoteObjectProxy.ircConnectionDidReceiveLines(receiveBatch)
 		}
 
-		sendQueue(add: data)
+		receiveBatch.removeAll(keepingCapacity: true)
 
-		tryToSend()
+		receiveBatchLength = 0
 	}
 
-	fileprivate func send(_ data: Data, removeFromQueue: Bool = false)
+	/// Delivers lines still waiting in the batch so that they
+	/// reach the app before the state change that follows.
+	fileprivate func flushReceiveBatchNow()
 	{
-		if (removeFromQueue) {
-			sendQueue(remove: data)
+		workerQueue?.sync {
+			flushReceiveBatch()
 		}
-
-		socket.write(data)
 	}
 
 	// MARK: - Flood Control
@@ -284,35 +382,70 @@ final class Connection: NSObject, ConnectionSocketDelegate
 	@objc
 	final func enforceFloodControl()
 	{
-		floodControlEnforced = true
+		workerQueue?.sync {
+			floodControlEnforced = true
+
+			floodControlTokens = Double(config.floodControlMaximumMessages)
+
+			floodControlLastRefill = DispatchTime.now().uptimeNanoseconds
+		}
 	}
 
-	fileprivate func startFloodControlTimer()
+	/// Number of tokens added to the bucket each second
+	fileprivate var floodControlRefillRate: Double
 	{
-		if (floodControlTimer.timerIsActive) {
-			return
-		}
+		let delayInterval = max(config.floodControlDelayInterval, 1)
 
-		let timerInterval = Double(config.floodControlDelayInterval)
+		return (Double(config.floodControlMaximumMessages) / Double(delayInterval))
+	}
 
-		floodControlTimer.start(timerInterval, onRepeat: true)
+	fileprivate func floodControlCost(of line: Data) -> Double
+	{
+		return (1.0 + (Double(line.count) / floodControlBytesPerToken))
 	}
 
-	fileprivate func stopFloodControlTimer()
+	/// floodControlRefill() must be called on the worker queue
+	fileprivate func floodControlRefill()
 	{
-		if (floodControlTimer.timerIsActive == false) {
+		if (floodControlEnforced == false) {
 			return
 		}
 
-		floodControlTimer.stop()
+		let currentTime = DispatchTime.now().uptimeNanoseconds
+
+		let secondsElapsed = (Double(currentTime - floodControlLastRefill) / 1_000_000_000)
+
+		floodControlLastRefill = currentTime
+
+		floodControlTokens = min((floodControlTokens + (secondsElapsed * floodControlRefillRate)),
+								 Double(config.floodControlMaximumMessages))
 	}
 
-	fileprivate func onFloodControlTimer()
+	/// floodControlScheduleWakeup() must be called on the worker queue
+	fileprivate func floodControlScheduleWakeup(for tokensRequired: Double)
 	{
-		floodControlCurrentMessageCount = 0
+		guard let workerQueue = workerQueue else {
+			return
+		}
+
+		if (floodControlWakeupScheduled) {
+			return
+		}
+
+		floodControlWakeupScheduled = true
+
+		let tokensNeeded = (tokensRequired - floodControlTokens)
 
-		while (tryToSend()) {
+		let delayInMicroseconds = Int(((tokensNeeded / floodControlRefillRate) * 1_000_000).rounded(.up))
 
+		workerQueue.asyncAfter(deadline: .now() + .microseconds(delayInMicroseconds)) { [weak self] in
+			guard let self = self else {
+				return
+			}
+
+			self.floodControlWakeupScheduled = false
+
+			self.sendNextWrite()
 		}
 	}
 
@@ -358,11 +491,15 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 	final func connectionClosedReadStream(_ connection: ConnectionSocket)
 	{
+		flushReceiveBatchNow()
+
 		remoteObjectProxy.ircConnectionDidCloseReadStream()
 	}
 
 	final func connectionDisconnected(_ connection: ConnectionSocket)
 	{
+		flushReceiveBatchNow()
+
 		resetState()
 
 		remoteObjectProxy.ircConnectionDidDisconnectWithError(nil)
@@ -370,6 +507,8 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 	final func connection(_ connection: ConnectionSocket, disconnectedWith error: ConnectionError)
 	{
+		flushReceiveBatchNow()
+
 		resetState()
 
 		remoteObjectProxy.ircConnectionDidDisconnectWithError(error as NSError)
@@ -377,7 +516,7 @@ final class Connection: NSObject, ConnectionSocketDelegate
 
 	final func connection(_ connection: ConnectionSocket, received data: Data)
 	{
-		remoteObjectProxy.ircConnectionDidReceive(data)
+		receiveBatch(add: data)
 	}
 
 	final func connection(_ connection: ConnectionSocket, willSend data: Data)
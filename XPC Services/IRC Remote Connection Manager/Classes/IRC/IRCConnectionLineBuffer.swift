@@ -0,0 +1,163 @@
+/* *********************************************************************
+*                  _____         _               _
+*                 |_   _|____  _| |_ _   _  __ _| |
+*                   | |/ _ \ \/ / __| | | |/ _` | |
+*                   | |  __/>  <| |_| |_| | (_| | |
+*                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+*
+*    Copyright (c) 2018 Codeux Software, LLC & respective contributors.
+*       Please see Acknowledgements.pdf for additional information.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+*  * Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*  * Neither the name of Textual, "Codeux Software, LLC", nor the
+*    names of its contributors may be used to endorse or promote products
+*    derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+*********************************************************************** */
+
+
+import Foundation
+
+/* ConnectionLineBuffer splits data read from a socket into lines.
+ It is shared by every ConnectionSocket subclass so that they
+ all frame lines the same way. */
+/* Complete lines found in data read in are handed out as slices of
+ that data which means they share its storage. Only the partial line
+ at the end of a read is copied into the buffer to be joined with the
+ data of the next read. That buffer is reused between reads. */
+final class ConnectionLineBuffer
+{
+	fileprivate var partialLine = Data()
+
+	fileprivate let maximumLength: Int
+
+	enum AppendError : Error
+	{
+		/// A line exceeds the maximum length
+		case lineTooLong
+	}
+
+	init (initialCapacity: Int = (1024 * 16), maximumLength: Int)
+	{
+		self.maximumLength = maximumLength
+
+		partialLine.reserveCapacity(initialCapacity)
+	}
+
+	/// Removes any partial line held from a previous read.
+	func reset()
+	{
+		partialLine.removeAll(keepingCapacity: true)
+	}
+
+	/// Splits data into lines and passes each to lineHandler in order.
+	/// Newlines and carriage returns are trimmed from the end of each line.
+	/// Empty lines are skipped.
+	/// Throws lineTooLong as soon as a line, complete or not, exceeds the
+	/// maximum length. Lines before it have already been passed on.
+	func append(_ data: Data, lineHandler: (Data) -> Void) throws
+	{
+		var lineStart = data.startIndex
+
+		try data.withUnsafeBytes { (bytes: UnsafeRawBufferPointer) in
+			guard let baseAddress = bytes.baseAddress else {
+				return
+			}
+
+			var searchOffset = 0
+
+			/* memchr() is vectorized by libc which makes it
+			 the fastest way available to find a newline. */
+			while (searchOffset < bytes.count) {
+				guard let newlinePointer = memchr(baseAddress + searchOffset, 0x0a, (bytes.count - searchOffset)) else {
+					break
+				}
+
+				let newlineOffset = (baseAddress.distance(to: UnsafeRawPointer(newlinePointer)))
+
+				let lineEnd = (data.startIndex + newlineOffset)
+
+				try checkLength(partialLine.count + (lineEnd - lineStart))
+
+				if (partialLine.isEmpty) {
+					emitLine(data[lineStart..<lineEnd], to: lineHandler)
+				} else {
+					/* The line started in a previous read */
+					partialLine.append(data[lineStart..<lineEnd])
+
+					emitLine(partialLine, to: lineHandler)
+
+					partialLine.removeAll(keepingCapacity: true)
+				}
+
+				searchOffset = (newlineOffset + 1)
+
+				lineStart = (data.startIndex + searchOffset)
+			}
+		}
+
+		/* Keep what remains until the next read */
+		if (lineStart < data.endIndex) {
+			try checkLength(partialLine.count + (data.endIndex - lineStart))
+
+			partialLine.append(data[lineStart..<data.endIndex])
+		}
+	}
+
+	fileprivate func checkLength(_ lineLength: Int) throws
+	{
+		if (lineLength <= maximumLength) {
+			return
+		}
+
+		partialLine.removeAll(keepingCapacity: true)
+
+		throw AppendError.lineTooLong
+	}
+
+	fileprivate func emitLine(_ line: Data, to lineHandler: (Data) -> Void)
+	{
+		var lineEnd = line.endIndex
+
+		/* Trim \r (and any extra \n) from the end of the line */
+		while (lineEnd > line.startIndex) {
+			let character = line[(lineEnd - 1)]
+
+			if (character != 0x0d && character != 0x0a) {
+				break
+			}
+
+			lineEnd -= 1
+		}
+
+		if (lineEnd == line.startIndex) {
+			return
+		}
+
+		if (lineEnd == line.endIndex) {
+			lineHandler(line)
+		} else {
+			lineHandler(line[line.startIndex..<lineEnd])
+		}
+	}
+}
@@ -0,0 +1,113 @@
+/* *********************************************************************
+*                  _____         _               _
+*                 |_   _|____  _| |_ _   _  __ _| |
+*                   | |/ _ \ \/ / __| | | |/ _` | |
+*                   | |  __/>  <| |_| |_| | (_| | |
+*                   |_|\___/_/\_\\__|\__,_|\__,_|_|
+*
+*    Copyright (c) 2018 Codeux Software, LLC & respective contributors.
+*       Please see Acknowledgements.pdf for additional information.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions
+* are met:
+*
+*  * Redistributions of source code must retain the above copyright
+*    notice, this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above copyright
+*    notice, this list of conditions and the following disclaimer in the
+*    documentation and/or other materials provided with the distribution.
+*  * Neither the name of Textual, "Codeux Software, LLC", nor the
+*    names of its contributors may be used to endorse or promote products
+*    derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE AUTHOR AND CONTRIBUTORS ``AS IS'' AND
+* ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE AUTHOR OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+* OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+* LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+* OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+* SUCH DAMAGE.
+*
+*********************************************************************** */
+
+
+import Foundation
+
+/* ConnectionSendQueue is a first-in, first-out queue of lines
+ waiting to be written to the socket. Lines are only ever added
+ to the end and removed from the front, which are both O(1).
+
+ Removed lines leave a hole at the front of the storage. The holes
+ are reclaimed in one pass once they make up half of the storage,
+ which keeps removal O(1) amortized without a ring of indexes. */
+struct ConnectionSendQueue
+{
+	fileprivate var storage: [Data] = []
+
+	fileprivate var head = 0
+
+	/// Number of lines in the queue
+	var count: Int
+	{
+		return (storage.count - head)
+	}
+
+	var isEmpty: Bool
+	{
+		return (count == 0)
+	}
+
+	/// The line at the front of the queue
+	var first: Data?
+	{
+		if (isEmpty) {
+			return nil
+		}
+
+		return storage[head]
+	}
+
+	mutating func append(_ line: Data)
+	{
+		storage.append(line)
+	}
+
+	@discardableResult
+	mutating func removeFirst() -> Data?
+	{
+		if (isEmpty) {
+			return nil
+		}
+
+		let line = storage[head]
+
+		/* Release the line now instead of when compacting */
+		storage[head] = Data()
+
+		head += 1
+
+		if (head == storage.count) {
+			storage.removeAll(keepingCapacity: true)
+
+			head = 0
+		} else if (head >= 32 && head >= (storage.count / 2)) {
+			storage.removeSubrange(0..<head)
+
+			head = 0
+		}
+
+		return line
+	}
+
+	mutating func removeAll()
+	{
+		storage.removeAll()
+
+		head = 0
+	}
+}
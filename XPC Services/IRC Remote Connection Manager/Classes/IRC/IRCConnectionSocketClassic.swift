@@ -61,7 +61,7 @@ final class ConnectionSocketClassic: ConnectionSocket, ConnectionSocketProtocol,
 
 	fileprivate var connection: GCDAsyncSocket?
 
-	fileprivate let readDelimiter = Data([0x0a]) // \n
+	fileprivate lazy var readInBuffer = ConnectionLineBuffer(maximumLength: maximumDataLength)
 
 	// MARK: - Grand Central Dispatch
 
@@ -167,6 +167,8 @@ final class ConnectionSocketClassic: ConnectionSocket, ConnectionSocketProtocol,
 	{
 		super.resetState()
 
+		readInBuffer.reset()
+
 		connection = nil
 
 		destroyDispatchQueues()
@@ -198,9 +200,9 @@ final class ConnectionSocketClassic: ConnectionSocket, ConnectionSocketProtocol,
 			return
 		}
 
-		connection?.readData(to: readDelimiter,
-							 withTimeout: Timeout.none.rawValue,
-							 maxLength: UInt(maximumDataLength),
+		/* Lines are framed by readInBuffer, not GCDAsyncSocket,
+		 so read whatever is available instead of up to \n. */
+		connection?.readData(withTimeout: Timeout.none.rawValue,
 							 tag: Tag.none.rawValue)
 	}
 
@@ -210,13 +212,13 @@ final class ConnectionSocketClassic: ConnectionSocket, ConnectionSocketProtocol,
 			return
 		}
 
-		/* We read until \n appears.
-		 Data returned by socket will include the \n
-		 and \r if it's present. We therefore trim the
-		 data of \r and \n when we read it in. */
-		let trimmedData = data.withoutNewlinesAtEnd
-
-		delegate?.connection(self, received: trimmedData)
+		do {
+			try readInBuffer.append(data) { (line) in
+				delegate?.connection(self, received: line)
+			}
+		} catch {
+			close(with: "Received a line which exceeds the maximum length allowed")
+		}
 	}
 
 	// MARK: - Properties
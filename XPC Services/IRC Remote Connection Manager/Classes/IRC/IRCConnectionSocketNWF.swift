@@ -41,7 +41,7 @@ import Network
 @available(macOS 10.14, *)
 final class ConnectionSocketNWF: ConnectionSocket, ConnectionSocketProtocol
 {
-	fileprivate var readInBuffer: Data?
+	fileprivate lazy var readInBuffer = ConnectionLineBuffer(maximumLength: maximumDataLength)
 
 	fileprivate var connection: NWConnection?
 
@@ -177,6 +177,8 @@ final class ConnectionSocketNWF: ConnectionSocket, ConnectionSocketProtocol
 	{
 		super.resetState()
 
+		readInBuffer.reset()
+
 		connection = nil
 
 		destroyDispatchQueues()
@@ -201,51 +203,12 @@ final class ConnectionSocketNWF: ConnectionSocket, ConnectionSocketProtocol
 			return
 		}
 
-		/* First combine the existing read buffer with the
-		 new data so we can process it in mass. */
-		/* Note: June 29, 2018 on Swift 4.2 on Xcode 10 beta 2
-		 When I first wrote this code, I wrote the logic in the
-		 form "newBuffer = (oldBuffer + data)" When writing it
-		 using this syntax, Foundation would throw at random
-		 an out of range exception similar to the following:
-
-		 *** Terminating app due to uncaught exception 'NSRangeException', reason: '*** -[NSConcreteMutableData subdataWithRange:]: range {12945, 87} exceeds data length 7282'
-
-		 TODO: Maybe this should be revisited at a later time. */
-		var newBuffer: Data
-
-		if let oldBuffer = readInBuffer {
-			newBuffer = oldBuffer
-		} else {
-			newBuffer = Data()
-		}
-
-		newBuffer.append(data)
-
-		/* Regardless of the result, we need to update the
-		 saved buffer with the updated buffer, but we prefer
-		 to wait until then end to do that. */
-		defer {
-			readInBuffer = newBuffer
-		}
-
-		/* Split the data */
-		guard let (lines, remainingData) = newBuffer.splitNetworkLines() else {
-			return
-		}
-
-		for line in lines {
-			delegate?.connection(self, received: line)
-		}
-
-		if let remainder = remainingData {
-			newBuffer = remainder
-		} else {
-			/* "Pass true to request that the collection avoid releasing its
-			 storage. Retaining the collection’s storage can be a useful
-			 optimization when you’re planning to grow the collection again." */
-
-			newBuffer.removeAll(keepingCapacity: true)
+		do {
+			try readInBuffer.append(data) { (line) in
+				delegate?.connection(self, received: line)
+			}
+		} catch {
+			close(with: "Received a line which exceeds the maximum length allowed")
 		}
 	}
 
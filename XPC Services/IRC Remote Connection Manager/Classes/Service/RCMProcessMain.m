@@ -91,15 +91,15 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (void)sendData:(NSData *)data
 {
-	[self sendData:data bypassQueue:NO];
+	[self sendData:data lane:RCMSendQueueLaneInteractive];
 }
 
-- (void)sendData:(NSData *)data bypassQueue:(BOOL)bypassQueue
+- (void)sendData:(NSData *)data lane:(RCMSendQueueLane)lane
 {
 	NSAssert((self.connection != nil),
 		 @"Method invoked without performing setup first");
 
-	[self.connection sendData:data bypassQueue:bypassQueue];
+	[self.connection sendData:data lane:lane];
 }
 
 - (void)exportSecureConnectionInformation:(NS_NOESCAPE RCMSecureConnectionInformationCompletionBlock)completionBlock